@@ -50,6 +50,8 @@ bool InitializeWindow(VkExtent2D size, bool fullScreen = false, bool isResizable
 			graphicsBase::Base().AddInstanceExtension(extensionNames[i]);
 		}
 		graphicsBase::Base().AddDeviceExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		//õɫʱڵInitializeWindow(...)ǰgraphicsBaseӦRequest
+		pipelineFeedback::RequestDeviceExtension();
 		//ڴwindow surfaceǰVulkanʵ
 		graphicsBase::Base().UseLatestApiVersion();
 		if (graphicsBase::Base().CreateInstance())
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "threadPool.hpp"
+
+// Asynchronous Pipeline
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 在后台编译的管线，编译完成前解析为指定的后备管线（比如通用的超级着色器或简化的变体）
+    // 录制命令时取其当前句柄即可，绘制不会因等待vkCreateGraphicsPipelines(...)而阻塞
+    // 换下的管线可能仍被在途的命令缓冲区引用：重新编译时先前编译的管线过framesInFlight帧才销毁，后备管线由调用者持有，须等FallbackReleasable()为true才能销毁
+    class asyncPipeline {
+    public:
+        using builder_t = std::function<result_t(pipeline&)>;
+    private:
+        struct state {
+            pipeline compiled;
+            std::atomic<bool> ready = false;
+            std::atomic<bool> failed = false;
+        };
+        //编译任务持有state的一份所有权，asyncPipeline先于任务析构时，管线随任务结束销毁
+        std::shared_ptr<state> pState;
+        std::shared_future<void> compiling;
+        VkPipeline fallback = VK_NULL_HANDLE;
+        retiredObjects<std::shared_ptr<state>> retiredStates;
+        uint32_t framesInFlight = 3;
+        uint32_t framesSinceReady = 0; //编译完成后经过的帧数，至多计到framesInFlight
+    public:
+        asyncPipeline() = default;
+        asyncPipeline(threadPool& pool, builder_t builder, VkPipeline fallback = VK_NULL_HANDLE, uint32_t framesInFlight = 3) :
+            framesInFlight(framesInFlight) {
+            Compile(pool, std::move(builder), fallback);
+        }
+        asyncPipeline(asyncPipeline&&) = default;
+        asyncPipeline& operator=(asyncPipeline&&) = default;
+        //Getter
+        //编译完成前返回后备管线，之后返回编译好的管线，编译失败时一直返回后备管线
+        VkPipeline Current() const {
+            if (pState && pState->ready.load(std::memory_order_acquire))
+                return pState->compiled;
+            return fallback;
+        }
+        operator VkPipeline() const { return Current(); }
+        bool Ready() const { return pState && pState->ready.load(std::memory_order_acquire); }
+        bool Failed() const { return pState && pState->failed.load(std::memory_order_acquire); }
+        //当前是否仍在使用后备管线，可用于统计或调试显示
+        bool UsingFallback() const { return !Ready(); }
+        VkPipeline Fallback() const { return fallback; }
+        //换上编译好的管线后已过framesInFlight帧，引用后备管线的命令均已执行完毕
+        bool FallbackReleasable() const { return framesSinceReady >= framesInFlight; }
+        //Const Function
+        //等待编译完成，用于加载画面等可以阻塞的场合
+        VkPipeline Wait() const {
+            if (compiling.valid())
+                compiling.wait();
+            return Current();
+        }
+        //Non-const Function
+        //提交编译，builder在线程池中调用，须线程安全
+        //重复调用时先前编译的管线被换下，过framesInFlight帧后销毁
+        void Compile(threadPool& pool, builder_t builder, VkPipeline fallback = VK_NULL_HANDLE) {
+            this->fallback = fallback;
+            if (pState)
+                retiredStates.Retire(std::move(pState), framesInFlight);
+            framesSinceReady = 0;
+            pState = std::make_shared<state>();
+            compiling = pool.Submit([pState = pState, builder = std::move(builder)] {
+                pipeline newPipeline;
+                if (builder(newPipeline)) {
+                    pState->failed.store(true, std::memory_order_release);
+                    return;
+                }
+                pState->compiled = std::move(newPipeline);
+                pState->ready.store(true, std::memory_order_release);
+            }).share();
+        }
+        //更换后备管线，比如后备管线本身也是异步编译的
+        void Fallback(VkPipeline fallback) { this->fallback = fallback; }
+        void FramesInFlight(uint32_t count) { framesInFlight = count; }
+        //在每帧开始时（栅栏等待之后）调用，销毁足够旧的被换下的管线，并计算后备管线何时可以销毁
+        void NextFrame() {
+            retiredStates.NextFrame();
+            if (Ready() && framesSinceReady < framesInFlight)
+                framesSinceReady++;
+        }
+    };
+}
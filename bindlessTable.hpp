@@ -0,0 +1,197 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Bindless Descriptor Table
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 基于描述符索引（Vulkan1.2核心功能）的全局描述符表，整个程序只需绑定一次
+    // 纹理、采样器、storage buffer登记到三个大数组中，得到的索引不变，着色器以此索引取用资源，绘制之间不必再绑定描述符集
+    // 描述符以update-after-bind、partially bound方式更新，已绑定的描述符集也可随时登记新资源
+    // 释放的索引须等到framesInFlight帧后（GPU不再使用时）才会被再次分配
+    // 着色器中的对应声明（HLSL）：
+    //     [[vk::binding(0, set)]] Texture2D textures[];
+    //     [[vk::binding(1, set)]] SamplerState samplers[];
+    //     [[vk::binding(2, set)]] ByteAddressBuffer buffers[];
+    //     取用时索引若非一致（dynamically non-uniform）须经NonUniformResourceIndex(...)
+    class bindlessTable {
+        struct slotArray {
+            uint32_t capacity = 0;
+            uint32_t nextSlot = 0;                              //从未分配过的首个索引
+            std::vector<uint32_t> freeSlots;
+            std::deque<std::pair<uint32_t, uint64_t>> retired; //（索引，释放时的帧序号）
+            uint32_t Allocate() {
+                if (freeSlots.size()) {
+                    uint32_t slot = freeSlots.back();
+                    freeSlots.pop_back();
+                    return slot;
+                }
+                return nextSlot < capacity ? nextSlot++ : UINT32_MAX;
+            }
+        };
+        descriptorSetLayout setLayout;
+        descriptorPool pool;
+        descriptorSet set;
+        slotArray textures;
+        slotArray samplers;
+        slotArray buffers;
+        std::mutex mutex;
+        uint64_t currentFrame = 0;
+        uint32_t framesInFlight;
+
+        uint32_t Register(slotArray& slots, const char* typeName, const VkWriteDescriptorSet& write) {
+            std::lock_guard lock(mutex);
+            uint32_t slot = slots.Allocate();
+            if (slot == UINT32_MAX) {
+                outStream << std::format("[ bindlessTable ] ERROR\nThe {} array is full, capacity: {}!\n", typeName, slots.capacity);
+                return UINT32_MAX;
+            }
+            VkWriteDescriptorSet writeDescriptorSet = write;
+            writeDescriptorSet.dstArrayElement = slot;
+            vkUpdateDescriptorSets(graphicsBase::Base().Device(), 1, &writeDescriptorSet, 0, nullptr);
+            return slot;
+        }
+        void Release(slotArray& slots, uint32_t slot) {
+            if (slot == UINT32_MAX)
+                return;
+            std::lock_guard lock(mutex);
+            slots.retired.emplace_back(slot, currentFrame);
+        }
+    public:
+        bindlessTable() = default;
+        bindlessTable(uint32_t maxTextureCount, uint32_t maxSamplerCount, uint32_t maxBufferCount, uint32_t framesInFlight = 2,
+            VkShaderStageFlags stages = VK_SHADER_STAGE_ALL) {
+            Create(maxTextureCount, maxSamplerCount, maxBufferCount, framesInFlight, stages);
+        }
+        bindlessTable(bindlessTable&&) = delete;
+        //Getter
+        VkDescriptorSetLayout SetLayout() const { return setLayout; }
+        VkDescriptorSet Set() const { return set; }
+        //Const Function
+        //在命令缓冲区开始时绑定一次，layout的第setIndex个描述符集布局须为SetLayout()
+        void CmdBind(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t setIndex = 0) const {
+            vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, setIndex, 1, set.Address(), 0, nullptr);
+        }
+        //Non-const Function
+        //登记资源，返回其在相应数组中的索引，数组已满时返回UINT32_MAX
+        uint32_t RegisterTexture(VkImageView imageView, VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+            VkDescriptorImageInfo imageInfo = { VK_NULL_HANDLE, imageView, imageLayout };
+            return Register(textures, "texture", {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = set,
+                .dstBinding = 0,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+                .pImageInfo = &imageInfo });
+        }
+        uint32_t RegisterSampler(VkSampler sampler) {
+            VkDescriptorImageInfo imageInfo = { sampler };
+            return Register(samplers, "sampler", {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = set,
+                .dstBinding = 1,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
+                .pImageInfo = &imageInfo });
+        }
+        uint32_t RegisterBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE) {
+            VkDescriptorBufferInfo bufferInfo = { buffer, offset, range };
+            return Register(buffers, "storage buffer", {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                .dstSet = set,
+                .dstBinding = 2,
+                .descriptorCount = 1,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .pBufferInfo = &bufferInfo });
+        }
+        //释放索引，描述符保留原样（partially bound，不被访问即可），framesInFlight帧后该索引才可被再次分配
+        void ReleaseTexture(uint32_t index) { Release(textures, index); }
+        void ReleaseSampler(uint32_t index) { Release(samplers, index); }
+        void ReleaseBuffer(uint32_t index) { Release(buffers, index); }
+        //在每帧开始时调用，回收framesInFlight帧前释放的索引
+        void BeginFrame() {
+            std::lock_guard lock(mutex);
+            currentFrame++;
+            for (auto slots : { &textures, &samplers, &buffers })
+                while (slots->retired.size() && slots->retired.front().second + framesInFlight <= currentFrame)
+                    slots->freeSlots.push_back(slots->retired.front().first),
+                    slots->retired.pop_front();
+        }
+        //各数组的容量被限制在设备允许的update-after-bind描述符个数以内
+        result_t Create(uint32_t maxTextureCount, uint32_t maxSamplerCount, uint32_t maxBufferCount, uint32_t framesInFlight = 2,
+            VkShaderStageFlags stages = VK_SHADER_STAGE_ALL) {
+            if (!Available()) {
+                outStream << std::format("[ bindlessTable ] ERROR\nDescriptor indexing is not supported!\n");
+                return VK_ERROR_FEATURE_NOT_PRESENT;
+            }
+            this->framesInFlight = framesInFlight;
+            VkPhysicalDeviceVulkan12Properties properties12 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES };
+            VkPhysicalDeviceProperties2 properties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &properties12 };
+            vkGetPhysicalDeviceProperties2(graphicsBase::Base().PhysicalDevice(), &properties);
+            textures.capacity = std::min({ maxTextureCount,
+                properties12.maxDescriptorSetUpdateAfterBindSampledImages, properties12.maxPerStageDescriptorUpdateAfterBindSampledImages });
+            samplers.capacity = std::min({ maxSamplerCount,
+                properties12.maxDescriptorSetUpdateAfterBindSamplers, properties12.maxPerStageDescriptorUpdateAfterBindSamplers });
+            buffers.capacity = std::min({ maxBufferCount,
+                properties12.maxDescriptorSetUpdateAfterBindStorageBuffers, properties12.maxPerStageDescriptorUpdateAfterBindStorageBuffers });
+            //只有最后一个绑定可以是可变数量的
+            VkDescriptorSetLayoutBinding bindings[3] = {
+                { 0, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, textures.capacity, stages },
+                { 1, VK_DESCRIPTOR_TYPE_SAMPLER, samplers.capacity, stages },
+                { 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffers.capacity, stages }
+            };
+            constexpr VkDescriptorBindingFlags bindingFlags =
+                VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+                VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT |
+                VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+            VkDescriptorBindingFlags bindingFlagsArray[3] = {
+                bindingFlags, bindingFlags, bindingFlags | VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT };
+            VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCreateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+                .bindingCount = 3,
+                .pBindingFlags = bindingFlagsArray
+            };
+            VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {
+                .pNext = &bindingFlagsCreateInfo,
+                .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+                .bindingCount = 3,
+                .pBindings = bindings
+            };
+            if (VkResult result = setLayout.Create(setLayoutCreateInfo))
+                return result;
+            VkDescriptorPoolSize poolSizes[3] = {
+                { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, textures.capacity },
+                { VK_DESCRIPTOR_TYPE_SAMPLER, samplers.capacity },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, buffers.capacity }
+            };
+            if (VkResult result = pool.Create(1, poolSizes, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT))
+                return result;
+            VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+                .descriptorSetCount = 1,
+                .pDescriptorCounts = &buffers.capacity
+            };
+            if (VkResult result = pool.AllocateSets(set, setLayout, &variableCountInfo)) {
+                outStream << std::format("[ bindlessTable ] ERROR\nFailed to allocate the bindless descriptor set!\nError code: {}\n", int32_t(result));
+                return result;
+            }
+            return VK_SUCCESS;
+        }
+        //Static Function
+        static bool Available() {
+            auto& base = graphicsBase::Base();
+            auto& features12 = base.PhysicalDeviceVulkan12Features();
+            return base.DeviceApiVersion() >= VK_API_VERSION_1_2 &&
+                features12.runtimeDescriptorArray &&
+                features12.descriptorBindingPartiallyBound &&
+                features12.descriptorBindingVariableDescriptorCount &&
+                features12.descriptorBindingUpdateUnusedWhilePending &&
+                features12.descriptorBindingSampledImageUpdateAfterBind &&
+                features12.descriptorBindingStorageBufferUpdateAfterBind &&
+                features12.shaderSampledImageArrayNonUniformIndexing &&
+                features12.shaderStorageBufferArrayNonUniformIndexing;
+        }
+    };
+}
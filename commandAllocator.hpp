@@ -0,0 +1,57 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Frame Command Allocator
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 每帧一个TRANSIENT命令池，帧内可取得任意多个命令缓冲区，该帧的栅栏置位后以一次vkResetCommandPool(...)整体重置
+    // 命令缓冲区在各帧间复用而不释放，录制时也无需逐个隐式重置，对多数驱动而言是开销最小的录制方式
+    class frameCommandAllocator {
+        struct frameSlot {
+            commandPool pool;
+            std::deque<commandBuffer> primaryBuffers; //用deque，追加元素时已取得的引用不失效
+            std::deque<commandBuffer> secondaryBuffers;
+            uint32_t primaryUsedCount = 0;
+            uint32_t secondaryUsedCount = 0;
+            fence frameFence{ VK_FENCE_CREATE_SIGNALED_BIT }; //以置位状态创建，首次BeginFrame()时不必等待
+        };
+        std::vector<frameSlot> slots;
+        uint32_t currentFrame = 0;
+    public:
+        frameCommandAllocator(uint32_t queueFamilyIndex, uint32_t framesInFlight = 2) :slots(framesInFlight) {
+            for (auto& i : slots)
+                i.pool.Create(queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+        }
+        frameCommandAllocator(frameCommandAllocator&&) = delete;
+        //Getter
+        uint32_t FramesInFlight() const { return uint32_t(slots.size()); }
+        uint32_t CurrentFrame() const { return currentFrame; }
+        //当帧的栅栏，当帧最后一次提交时须用它，BeginFrame()据此判断命令池可否重置
+        VkFence Fence() const { return slots[currentFrame].frameFence; }
+        //Non-const Function
+        //切换到下一帧，等待其栅栏后重置栅栏和命令池，此后当帧必须提交一次以Fence()为栅栏的命令
+        result_t BeginFrame() {
+            currentFrame = (currentFrame + 1) % slots.size();
+            auto& slot = slots[currentFrame];
+            if (VkResult result = slot.frameFence.WaitAndReset())
+                return result;
+            if (VkResult result = slot.pool.Reset())
+                return result;
+            slot.primaryUsedCount = slot.secondaryUsedCount = 0;
+            return VK_SUCCESS;
+        }
+        //取得一个当帧可用的命令缓冲区，引用在该帧再次开始前有效
+        commandBuffer& Allocate(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY) {
+            auto& slot = slots[currentFrame];
+            bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            auto& buffers = primary ? slot.primaryBuffers : slot.secondaryBuffers;
+            uint32_t& usedCount = primary ? slot.primaryUsedCount : slot.secondaryUsedCount;
+            if (usedCount == buffers.size())
+                slot.pool.AllocateBuffers(buffers.emplace_back(), level);
+            return buffers[usedCount++];
+        }
+    };
+}
@@ -0,0 +1,350 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Redundant-state-eliding Command Encoder
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 包在命令缓冲区外的一层，记下当前绑定的管线、描述符集、顶点/索引缓冲区、push constant和动态状态
+    // 与当前状态相同的vkCmdBind*/vkCmdSet*/vkCmdPushConstants调用被略去，材质繁多的场景中可省下大量录制开销
+    // 绘制等其余命令直接以VkCommandBuffer调用即可，对命令缓冲区的其他改动状态的调用（包括vkCmdExecuteCommands）后须Invalidate()
+    class commandEncoder {
+    public:
+        struct statistics {
+            uint64_t issued = 0; //实际录制的调用数
+            uint64_t elided = 0; //被略去的调用数
+        };
+        static constexpr uint32_t maxDescriptorSetCount = 8;
+        static constexpr uint32_t maxVertexBindingCount = 32;
+        static constexpr uint32_t maxViewportCount = 16;
+        static constexpr uint32_t maxPushConstantSize = 256;
+    private:
+        //所跟踪的动态状态各占一位，绑定不含某动态状态的管线时其值被管线覆盖，须清除相应的位
+        enum dynamicStateBit :uint32_t {
+            lineWidthBit = 1 << 0,
+            depthBiasBit = 1 << 1,
+            blendConstantsBit = 1 << 2,
+            stencilCompareMaskFrontBit = 1 << 3,
+            stencilCompareMaskBackBit = 1 << 4,
+            stencilWriteMaskFrontBit = 1 << 5,
+            stencilWriteMaskBackBit = 1 << 6,
+            stencilReferenceFrontBit = 1 << 7,
+            stencilReferenceBackBit = 1 << 8,
+            cullModeBit = 1 << 9,
+            frontFaceBit = 1 << 10,
+            primitiveTopologyBit = 1 << 11,
+            depthTestEnableBit = 1 << 12,
+            depthWriteEnableBit = 1 << 13,
+            depthCompareOpBit = 1 << 14,
+            viewportBit = 1 << 15,
+            scissorBit = 1 << 16
+        };
+        struct boundDescriptorSet {
+            VkPipelineLayout layout = VK_NULL_HANDLE;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            std::vector<uint32_t> dynamicOffsets;
+            bool valid = false;
+        };
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        statistics stats;
+        //Pipeline & descriptor sets，按绑定点（图形、计算、光追）分开
+        VkPipeline pipelines[3] = {};
+        boundDescriptorSet descriptorSets[3][maxDescriptorSetCount];
+        //Vertex & index buffers
+        VkBuffer vertexBuffers[maxVertexBindingCount] = {};
+        VkDeviceSize vertexBufferOffsets[maxVertexBindingCount] = {};
+        uint32_t vertexBufferValidMask = 0;
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        VkDeviceSize indexBufferOffset = 0;
+        VkIndexType indexType = VK_INDEX_TYPE_MAX_ENUM;
+        //Push constants
+        VkPipelineLayout pushConstantLayout = VK_NULL_HANDLE;
+        VkShaderStageFlags pushConstantStages = 0;
+        uint8_t pushConstantData[maxPushConstantSize] = {};
+        std::bitset<maxPushConstantSize> pushConstantValid;
+        //Dynamic state
+        uint32_t dynamicStateValid = 0;
+        VkViewport viewports[maxViewportCount] = {};
+        VkRect2D scissors[maxViewportCount] = {};
+        uint32_t viewportValidMask = 0;
+        uint32_t scissorValidMask = 0;
+        float lineWidth = 0;
+        float depthBias[3] = {};
+        float blendConstants[4] = {};
+        uint32_t stencilCompareMasks[2] = {};
+        uint32_t stencilWriteMasks[2] = {};
+        uint32_t stencilReferences[2] = {};
+        VkCullModeFlags cullMode = 0;
+        VkFrontFace frontFace = VK_FRONT_FACE_MAX_ENUM;
+        VkPrimitiveTopology primitiveTopology = VK_PRIMITIVE_TOPOLOGY_MAX_ENUM;
+        VkBool32 depthTestEnable = false;
+        VkBool32 depthWriteEnable = false;
+        VkCompareOp depthCompareOp = VK_COMPARE_OP_MAX_ENUM;
+
+        static uint32_t BindPointIndex(VkPipelineBindPoint bindPoint) {
+            return bindPoint == VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR ? 2 : bindPoint;
+        }
+        static uint32_t DynamicStateBits(VkDynamicState dynamicState) {
+            switch (dynamicState) {
+            case VK_DYNAMIC_STATE_VIEWPORT: return viewportBit;
+            case VK_DYNAMIC_STATE_SCISSOR: return scissorBit;
+            case VK_DYNAMIC_STATE_LINE_WIDTH: return lineWidthBit;
+            case VK_DYNAMIC_STATE_DEPTH_BIAS: return depthBiasBit;
+            case VK_DYNAMIC_STATE_BLEND_CONSTANTS: return blendConstantsBit;
+            case VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK: return stencilCompareMaskFrontBit | stencilCompareMaskBackBit;
+            case VK_DYNAMIC_STATE_STENCIL_WRITE_MASK: return stencilWriteMaskFrontBit | stencilWriteMaskBackBit;
+            case VK_DYNAMIC_STATE_STENCIL_REFERENCE: return stencilReferenceFrontBit | stencilReferenceBackBit;
+            case VK_DYNAMIC_STATE_CULL_MODE: return cullModeBit;
+            case VK_DYNAMIC_STATE_FRONT_FACE: return frontFaceBit;
+            case VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY: return primitiveTopologyBit;
+            case VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE: return depthTestEnableBit;
+            case VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE: return depthWriteEnableBit;
+            case VK_DYNAMIC_STATE_DEPTH_COMPARE_OP: return depthCompareOpBit;
+            default: return 0;
+            }
+        }
+        //状态有效且值相同时返回false并计入略去的调用，否则更新缓存的值并返回true
+        template<typename T>
+        bool Changed(uint32_t bit, T& cached, const T& value) {
+            if (dynamicStateValid & bit && !memcmp(&cached, &value, sizeof(T)))
+                return stats.elided++, false;
+            memcpy(&cached, &value, sizeof(T));
+            dynamicStateValid |= bit;
+            return stats.issued++, true;
+        }
+        //按面更新模板状态，只调用值有变化的面
+        void SetStencilState(uint32_t (&cached)[2], uint32_t frontBit, VkStencilFaceFlags faceMask, uint32_t value,
+            PFN_vkCmdSetStencilCompareMask function) {
+            VkStencilFaceFlags changedFaces = 0;
+            for (uint32_t i = 0; i < 2; i++)
+                if (faceMask & (VK_STENCIL_FACE_FRONT_BIT << i) && (!(dynamicStateValid & frontBit << i) || cached[i] != value))
+                    changedFaces |= VK_STENCIL_FACE_FRONT_BIT << i,
+                    cached[i] = value,
+                    dynamicStateValid |= frontBit << i;
+            if (!changedFaces)
+                return void(stats.elided++);
+            function(commandBuffer, changedFaces, value);
+            stats.issued++;
+        }
+    public:
+        commandEncoder() = default;
+        commandEncoder(VkCommandBuffer commandBuffer) :commandBuffer(commandBuffer) {}
+        //Getter
+        VkCommandBuffer CommandBuffer() const { return commandBuffer; }
+        operator VkCommandBuffer() const { return commandBuffer; }
+        const statistics& Statistics() const { return stats; }
+        //Non-const Function
+        //改为对另一个（刚开始录制的）命令缓冲区录制，已跟踪的状态全部作废，统计保留
+        void Reset(VkCommandBuffer commandBuffer) {
+            this->commandBuffer = commandBuffer;
+            Invalidate();
+        }
+        //作废已跟踪的状态，之后的每种状态的首次调用必然被录制
+        void Invalidate() {
+            for (auto& i : pipelines)
+                i = VK_NULL_HANDLE;
+            for (auto& i : descriptorSets)
+                for (auto& j : i)
+                    j.valid = false;
+            vertexBufferValidMask = 0;
+            indexBuffer = VK_NULL_HANDLE;
+            pushConstantValid.reset();
+            dynamicStateValid = 0;
+            viewportValidMask = scissorValidMask = 0;
+        }
+        void ResetStatistics() { stats = {}; }
+        //绑定管线，dynamicStates为该管线的动态状态，其余跟踪中的动态状态会被管线中的静态值覆盖，因而作废
+        //不提供dynamicStates时作废所有动态状态，这总是正确的，只是可能少略去一些调用
+        void BindPipeline(VkPipelineBindPoint bindPoint, VkPipeline pipeline, arrayRef<const VkDynamicState> dynamicStates = {}) {
+            VkPipeline& bound = pipelines[BindPointIndex(bindPoint)];
+            if (bound == pipeline)
+                return void(stats.elided++);
+            vkCmdBindPipeline(commandBuffer, bindPoint, bound = pipeline);
+            stats.issued++;
+            if (bindPoint != VK_PIPELINE_BIND_POINT_GRAPHICS)
+                return;
+            uint32_t keptBits = 0;
+            for (auto i : dynamicStates)
+                keptBits |= DynamicStateBits(i);
+            dynamicStateValid &= keptBits;
+            if (!(keptBits & viewportBit))
+                viewportValidMask = 0;
+            if (!(keptBits & scissorBit))
+                scissorValidMask = 0;
+        }
+        //以不同的管线布局绑定描述符集可能使其他编号的描述符集失效，这里将布局不同的已绑定描述符集一概视为失效
+        void BindDescriptorSets(VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t firstSet,
+            arrayRef<const VkDescriptorSet> sets, arrayRef<const uint32_t> dynamicOffsets = {}) {
+            auto& bound = descriptorSets[BindPointIndex(bindPoint)];
+            //超出跟踪范围时照常录制，作废所绑定的及可能因布局不同而失效的已跟踪描述符集，下同
+            if (firstSet + sets.Count() > maxDescriptorSetCount) {
+                for (uint32_t i = 0; i < maxDescriptorSetCount; i++)
+                    if (i >= firstSet || bound[i].layout != layout)
+                        bound[i].valid = false;
+                vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, firstSet,
+                    uint32_t(sets.Count()), sets.Pointer(), uint32_t(dynamicOffsets.Count()), dynamicOffsets.Pointer());
+                return void(stats.issued++);
+            }
+            //多个描述符集连同动态偏移一起绑定时，无从得知各偏移属于哪个描述符集，不略去，绑定后也不记入
+            bool trackable = sets.Count() == 1 || !dynamicOffsets.Count();
+            bool same = trackable;
+            for (size_t i = 0; same && i < sets.Count(); i++) {
+                auto& slot = bound[firstSet + i];
+                same = slot.valid && slot.layout == layout && slot.set == sets[i] &&
+                    std::ranges::equal(slot.dynamicOffsets, dynamicOffsets);
+            }
+            if (same)
+                return void(stats.elided++);
+            vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, firstSet,
+                uint32_t(sets.Count()), sets.Pointer(), uint32_t(dynamicOffsets.Count()), dynamicOffsets.Pointer());
+            stats.issued++;
+            for (auto& i : bound)
+                if (i.layout != layout)
+                    i.valid = false;
+            for (size_t i = 0; i < sets.Count(); i++) {
+                auto& slot = bound[firstSet + i];
+                slot.layout = layout;
+                slot.set = sets[i];
+                slot.dynamicOffsets.assign(dynamicOffsets.begin(), dynamicOffsets.end());
+                slot.valid = trackable;
+            }
+        }
+        //只录制有变化的那一段连续的绑定
+        void BindVertexBuffers(uint32_t firstBinding, arrayRef<const VkBuffer> buffers, arrayRef<const VkDeviceSize> offsets) {
+            uint32_t count = uint32_t(buffers.Count());
+            if (firstBinding + count > maxVertexBindingCount) {
+                if (firstBinding < maxVertexBindingCount)
+                    vertexBufferValidMask &= (1u << firstBinding) - 1;
+                vkCmdBindVertexBuffers(commandBuffer, firstBinding, count, buffers.Pointer(), offsets.Pointer());
+                return void(stats.issued++);
+            }
+            uint32_t begin = count, end = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                uint32_t binding = firstBinding + i;
+                if (vertexBufferValidMask & 1 << binding &&
+                    vertexBuffers[binding] == buffers[i] && vertexBufferOffsets[binding] == offsets[i])
+                    continue;
+                begin = std::min(begin, i), end = i + 1;
+                vertexBuffers[binding] = buffers[i];
+                vertexBufferOffsets[binding] = offsets[i];
+                vertexBufferValidMask |= 1 << binding;
+            }
+            if (begin >= end)
+                return void(stats.elided++);
+            vkCmdBindVertexBuffers(commandBuffer, firstBinding + begin, end - begin, buffers.Pointer() + begin, offsets.Pointer() + begin);
+            stats.issued++;
+        }
+        void BindIndexBuffer(VkBuffer buffer, VkDeviceSize offset, VkIndexType indexType) {
+            if (indexBuffer == buffer && indexBufferOffset == offset && this->indexType == indexType)
+                return void(stats.elided++);
+            vkCmdBindIndexBuffer(commandBuffer, indexBuffer = buffer, indexBufferOffset = offset, this->indexType = indexType);
+            stats.issued++;
+        }
+        //与先前以同样的布局和阶段推送过的内容逐字节比较，完全相同时略去
+        void PushConstants(VkPipelineLayout layout, VkShaderStageFlags stageFlags, uint32_t offset, uint32_t size, const void* pValues) {
+            if (offset + size > maxPushConstantSize) {
+                for (uint32_t i = offset; i < maxPushConstantSize; i++)
+                    pushConstantValid.reset(i);
+                vkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
+                return void(stats.issued++);
+            }
+            if (layout != pushConstantLayout || stageFlags != pushConstantStages)
+                pushConstantLayout = layout,
+                pushConstantStages = stageFlags,
+                pushConstantValid.reset();
+            bool same = !memcmp(pushConstantData + offset, pValues, size);
+            for (uint32_t i = offset; same && i < offset + size; i++)
+                same = pushConstantValid[i];
+            if (same)
+                return void(stats.elided++);
+            memcpy(pushConstantData + offset, pValues, size);
+            for (uint32_t i = offset; i < offset + size; i++)
+                pushConstantValid.set(i);
+            vkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
+            stats.issued++;
+        }
+        void SetViewports(uint32_t firstViewport, arrayRef<const VkViewport> viewports) {
+            uint32_t count = uint32_t(viewports.Count());
+            if (firstViewport + count > maxViewportCount) {
+                if (firstViewport < maxViewportCount)
+                    viewportValidMask &= (1u << firstViewport) - 1;
+                vkCmdSetViewport(commandBuffer, firstViewport, count, viewports.Pointer());
+                return void(stats.issued++);
+            }
+            uint32_t mask = ((1u << count) - 1) << firstViewport;
+            if ((viewportValidMask & mask) == mask &&
+                !memcmp(this->viewports + firstViewport, viewports.Pointer(), count * sizeof(VkViewport)))
+                return void(stats.elided++);
+            memcpy(this->viewports + firstViewport, viewports.Pointer(), count * sizeof(VkViewport));
+            viewportValidMask |= mask;
+            vkCmdSetViewport(commandBuffer, firstViewport, count, viewports.Pointer());
+            stats.issued++;
+        }
+        void SetScissors(uint32_t firstScissor, arrayRef<const VkRect2D> scissors) {
+            uint32_t count = uint32_t(scissors.Count());
+            if (firstScissor + count > maxViewportCount) {
+                if (firstScissor < maxViewportCount)
+                    scissorValidMask &= (1u << firstScissor) - 1;
+                vkCmdSetScissor(commandBuffer, firstScissor, count, scissors.Pointer());
+                return void(stats.issued++);
+            }
+            uint32_t mask = ((1u << count) - 1) << firstScissor;
+            if ((scissorValidMask & mask) == mask &&
+                !memcmp(this->scissors + firstScissor, scissors.Pointer(), count * sizeof(VkRect2D)))
+                return void(stats.elided++);
+            memcpy(this->scissors + firstScissor, scissors.Pointer(), count * sizeof(VkRect2D));
+            scissorValidMask |= mask;
+            vkCmdSetScissor(commandBuffer, firstScissor, count, scissors.Pointer());
+            stats.issued++;
+        }
+        void SetLineWidth(float lineWidth) {
+            if (Changed(lineWidthBit, this->lineWidth, lineWidth))
+                vkCmdSetLineWidth(commandBuffer, lineWidth);
+        }
+        void SetDepthBias(float constantFactor, float clamp, float slopeFactor) {
+            float values[3] = { constantFactor, clamp, slopeFactor };
+            if (Changed(depthBiasBit, depthBias, values))
+                vkCmdSetDepthBias(commandBuffer, constantFactor, clamp, slopeFactor);
+        }
+        void SetBlendConstants(const float (&blendConstants)[4]) {
+            if (Changed(blendConstantsBit, this->blendConstants, blendConstants))
+                vkCmdSetBlendConstants(commandBuffer, blendConstants);
+        }
+        void SetStencilCompareMask(VkStencilFaceFlags faceMask, uint32_t compareMask) {
+            SetStencilState(stencilCompareMasks, stencilCompareMaskFrontBit, faceMask, compareMask, vkCmdSetStencilCompareMask);
+        }
+        void SetStencilWriteMask(VkStencilFaceFlags faceMask, uint32_t writeMask) {
+            SetStencilState(stencilWriteMasks, stencilWriteMaskFrontBit, faceMask, writeMask, vkCmdSetStencilWriteMask);
+        }
+        void SetStencilReference(VkStencilFaceFlags faceMask, uint32_t reference) {
+            SetStencilState(stencilReferences, stencilReferenceFrontBit, faceMask, reference, vkCmdSetStencilReference);
+        }
+        //以下为Vulkan1.3的扩展动态状态
+        void SetCullMode(VkCullModeFlags cullMode) {
+            if (Changed(cullModeBit, this->cullMode, cullMode))
+                vkCmdSetCullMode(commandBuffer, cullMode);
+        }
+        void SetFrontFace(VkFrontFace frontFace) {
+            if (Changed(frontFaceBit, this->frontFace, frontFace))
+                vkCmdSetFrontFace(commandBuffer, frontFace);
+        }
+        void SetPrimitiveTopology(VkPrimitiveTopology primitiveTopology) {
+            if (Changed(primitiveTopologyBit, this->primitiveTopology, primitiveTopology))
+                vkCmdSetPrimitiveTopology(commandBuffer, primitiveTopology);
+        }
+        void SetDepthTestEnable(VkBool32 depthTestEnable) {
+            if (Changed(depthTestEnableBit, this->depthTestEnable, depthTestEnable))
+                vkCmdSetDepthTestEnable(commandBuffer, depthTestEnable);
+        }
+        void SetDepthWriteEnable(VkBool32 depthWriteEnable) {
+            if (Changed(depthWriteEnableBit, this->depthWriteEnable, depthWriteEnable))
+                vkCmdSetDepthWriteEnable(commandBuffer, depthWriteEnable);
+        }
+        void SetDepthCompareOp(VkCompareOp depthCompareOp) {
+            if (Changed(depthCompareOpBit, this->depthCompareOp, depthCompareOp))
+                vkCmdSetDepthCompareOp(commandBuffer, depthCompareOp);
+        }
+    };
+}
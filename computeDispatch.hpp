@@ -0,0 +1,242 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "spirvReflection.hpp"
+
+// Compute Dispatch
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 计算管线及其工作组大小
+    class computeKernel {
+        pipeline kernelPipeline;
+        VkPipelineLayout layout = VK_NULL_HANDLE;
+        uint32_t localSize[3] = { 1, 1, 1 };
+    public:
+        computeKernel() = default;
+        computeKernel(computePipelineCreateInfoPack& pack) {
+            Create(pack);
+        }
+        computeKernel(computeKernel&&) = default;
+        computeKernel& operator=(computeKernel&&) = default;
+        //Getter
+        VkPipeline Pipeline() const { return kernelPipeline; }
+        VkPipelineLayout Layout() const { return layout; }
+        const uint32_t* LocalSize() const { return localSize; }
+        //Const Function
+        //将线程数向上取整为工作组数
+        std::array<uint32_t, 3> GroupCount(uint32_t threadCountX, uint32_t threadCountY = 1, uint32_t threadCountZ = 1) const {
+            return {
+                (threadCountX + localSize[0] - 1) / localSize[0],
+                (threadCountY + localSize[1] - 1) / localSize[1],
+                (threadCountZ + localSize[2] - 1) / localSize[2] };
+        }
+        //Non-const Function
+        result_t Create(computePipelineCreateInfoPack& pack) {
+            if (VkResult result = kernelPipeline.Create(pack))
+                return result;
+            layout = pack.createInfo.layout;
+            std::ranges::copy(pack.localSize, localSize);
+            return VK_SUCCESS;
+        }
+        //由SPIR-V文件创建，工作组大小取自着色器中的LocalSize
+        result_t Create(const char* filepath, VkPipelineLayout layout, const char* entry = "main", const VkSpecializationInfo* pSpecializationInfo = nullptr) {
+            std::vector<uint32_t> code;
+            if (VkResult result = shaderModule::ReadCode(filepath, code))
+                return result;
+            shaderReflection reflection;
+            if (VkResult result = reflection.Reflect(code))
+                return result;
+            shaderModule module(code.size() * 4, code.data());
+            if (!module)
+                return VK_RESULT_MAX_ENUM;
+            computePipelineCreateInfoPack pack(module.StageCreateInfo(VK_SHADER_STAGE_COMPUTE_BIT, entry, pSpecializationInfo), layout,
+                std::max(reflection.localSize[0], 1u), std::max(reflection.localSize[1], 1u), std::max(reflection.localSize[2], 1u));
+            return Create(pack);
+        }
+    };
+
+    // 在一个命令缓冲区中录制一串计算调度，每次调度声明其读写的缓冲区和图像
+    // 后续调度依赖先前调度的写入时（写后读、写后写）自动插入内存屏障，写先前读过的资源时（读后写）插入执行依赖
+    // 图像须处于VK_IMAGE_LAYOUT_GENERAL
+    class computeRecorder {
+    public:
+        struct bufferAccess {
+            VkBuffer buffer;
+            bool write = false;
+            VkDeviceSize offset = 0;
+            VkDeviceSize size = VK_WHOLE_SIZE;
+        };
+        struct imageAccess {
+            VkImage image;
+            bool write = false;
+            VkImageSubresourceRange subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+        };
+    private:
+        struct accessState {
+            bool written = false; //有尚未经屏障可见的写入
+            bool read = false;    //上次屏障后有读取
+        };
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        VkPipeline boundPipeline = VK_NULL_HANDLE;
+        std::unordered_map<VkBuffer, accessState> bufferStates;
+        std::unordered_map<VkImage, accessState> imageStates;
+        std::vector<VkBufferMemoryBarrier> bufferBarriers;
+        std::vector<VkImageMemoryBarrier> imageBarriers;
+        std::vector<accessState*> coveredStates; //写入随待发出的屏障对计算着色器可见的资源的状态
+        VkPipelineStageFlags dstStages = 0;
+        uint32_t barrierCount = 0;
+
+        //记下此次访问所需的目标阶段，返回是否需要内存屏障
+        bool Hazard(accessState& state, bool write, VkPipelineStageFlags dstStage) {
+            if (state.written || (write && state.read))
+                dstStages |= dstStage;
+            return state.written;
+        }
+        void Track(accessState& state, bool write) {
+            if (write)
+                state.written = true,
+                state.read = false;
+            else
+                state.read = true;
+        }
+        void CollectBarrier(const bufferAccess& access, VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+            auto& state = bufferStates[access.buffer];
+            if (!Hazard(state, access.write, dstStage))
+                return;
+            //屏障只对dstStage可见，目标不是计算着色器时（如间接调度的参数）保留写入状态，之后的调度读取时另行同步
+            //状态按整个缓冲区跟踪，清除状态时屏障须覆盖整个缓冲区
+            bool covered = dstStage == VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            if (covered)
+                coveredStates.push_back(&state);
+            bufferBarriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = dstAccess,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = access.buffer,
+                .offset = covered ? 0 : access.offset,
+                .size = covered ? VK_WHOLE_SIZE : access.size });
+        }
+        void CollectBarrier(const imageAccess& access) {
+            auto& state = imageStates[access.image];
+            if (!Hazard(state, access.write, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT))
+                return;
+            //图像同样按整体跟踪，屏障覆盖其所有mip等级和图层
+            coveredStates.push_back(&state);
+            imageBarriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | (access.write ? VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT) : VkAccessFlags(0)),
+                .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+                .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = access.image,
+                .subresourceRange = { access.subresourceRange.aspectMask, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS } });
+        }
+        //合并为一次vkCmdPipelineBarrier(...)，只有屏障所覆盖的资源的写入被同步，其他资源尚未可见的写入保留
+        void FlushBarriers() {
+            if (!dstStages)
+                return;
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStages, 0,
+                0, nullptr,
+                uint32_t(bufferBarriers.size()), bufferBarriers.data(),
+                uint32_t(imageBarriers.size()), imageBarriers.data());
+            //unordered_map的元素地址在插入后不变
+            for (auto pState : coveredStates)
+                *pState = {};
+            coveredStates.clear();
+            bufferBarriers.clear();
+            imageBarriers.clear();
+            dstStages = 0;
+            barrierCount++;
+        }
+        void PrepareDispatch(const computeKernel& kernel, arrayRef<const bufferAccess> buffers, arrayRef<const imageAccess> images) {
+            for (auto& i : buffers)
+                CollectBarrier(i, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_ACCESS_SHADER_READ_BIT | (i.write ? VkAccessFlags(VK_ACCESS_SHADER_WRITE_BIT) : VkAccessFlags(0)));
+            for (auto& i : images)
+                CollectBarrier(i);
+            FlushBarriers();
+            for (auto& i : buffers)
+                Track(bufferStates[i.buffer], i.write);
+            for (auto& i : images)
+                Track(imageStates[i.image], i.write);
+            if (boundPipeline != kernel.Pipeline())
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, boundPipeline = kernel.Pipeline());
+        }
+    public:
+        computeRecorder() = default;
+        computeRecorder(VkCommandBuffer commandBuffer) :commandBuffer(commandBuffer) {}
+        //Getter
+        VkCommandBuffer CommandBuffer() const { return commandBuffer; }
+        //已插入的屏障数，可用以检查依赖声明是否合理
+        uint32_t BarrierCount() const { return barrierCount; }
+        //Non-const Function
+        //开始录制，命令缓冲区须来自计算队列族的命令池
+        result_t Begin(VkCommandBuffer commandBuffer, VkCommandBufferUsageFlags usageFlags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT) {
+            this->commandBuffer = commandBuffer;
+            boundPipeline = VK_NULL_HANDLE;
+            bufferStates.clear();
+            imageStates.clear();
+            barrierCount = 0;
+            VkCommandBufferBeginInfo beginInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .flags = usageFlags
+            };
+            VkResult result = vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            if (result)
+                outStream << std::format("[ computeRecorder ] ERROR\nFailed to begin a command buffer!\nError code: {}\n", int32_t(result));
+            return result;
+        }
+        //按线程数调度，工作组数由kernel的工作组大小向上取整
+        void Dispatch(const computeKernel& kernel, uint32_t threadCountX, uint32_t threadCountY = 1, uint32_t threadCountZ = 1,
+            arrayRef<const bufferAccess> buffers = {}, arrayRef<const imageAccess> images = {}) {
+            PrepareDispatch(kernel, buffers, images);
+            auto [x, y, z] = kernel.GroupCount(threadCountX, threadCountY, threadCountZ);
+            vkCmdDispatch(commandBuffer, x, y, z);
+        }
+        //间接调度，工作组数由indirectBuffer中的VkDispatchIndirectCommand提供，若其由先前的调度写入，自动插入屏障
+        void DispatchIndirect(const computeKernel& kernel, VkBuffer indirectBuffer, VkDeviceSize offset = 0,
+            arrayRef<const bufferAccess> buffers = {}, arrayRef<const imageAccess> images = {}) {
+            CollectBarrier({ indirectBuffer, false, offset, sizeof(VkDispatchIndirectCommand) },
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+            PrepareDispatch(kernel, buffers, images);
+            Track(bufferStates[indirectBuffer], false);
+            vkCmdDispatchIndirect(commandBuffer, indirectBuffer, offset);
+        }
+        void PushConstants(const computeKernel& kernel, uint32_t offset, uint32_t size, const void* pData) const {
+            vkCmdPushConstants(commandBuffer, kernel.Layout(), VK_SHADER_STAGE_COMPUTE_BIT, offset, size, pData);
+        }
+        void BindDescriptorSets(const computeKernel& kernel, uint32_t firstSet, arrayRef<const VkDescriptorSet> descriptorSets) const {
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, kernel.Layout(), firstSet,
+                uint32_t(descriptorSets.Count()), descriptorSets.Pointer(), 0, nullptr);
+        }
+        //使所有调度的写入对后续的其他阶段可见，比如在同一命令缓冲区中接着绘制时，dstStage为顶点输入或间接绘制
+        void MakeVisible(VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+            VkMemoryBarrier memoryBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = dstAccess
+            };
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dstStage, 0,
+                1, &memoryBarrier, 0, nullptr, 0, nullptr);
+            barrierCount++;
+        }
+        result_t End() const {
+            VkResult result = vkEndCommandBuffer(commandBuffer);
+            if (result)
+                outStream << std::format("[ computeRecorder ] ERROR\nFailed to end a command buffer!\nError code: {}\n", int32_t(result));
+            return result;
+        }
+        //结束录制并提交到计算队列
+        result_t Submit(VkFence fence = VK_NULL_HANDLE) const {
+            if (VkResult result = End())
+                return result;
+            return graphicsBase::Base().SubmitCommandBuffer_Compute(commandBuffer, fence);
+        }
+    };
+}
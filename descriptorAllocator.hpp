@@ -0,0 +1,135 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Descriptor Allocator
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 按需创建描述符池的分配器，各类描述符的个数为池中描述符集数乘以相应的比例
+    // 池耗尽（VK_ERROR_OUT_OF_POOL_MEMORY或VK_ERROR_FRAGMENTED_POOL）时换一个新池重试，新池的容量逐次增大
+    // 长期存在的描述符集直接用它分配，不重置；每帧临时的描述符集用frameDescriptorAllocator
+    class descriptorAllocator {
+    public:
+        struct poolSizeRatio {
+            VkDescriptorType type;
+            float ratio; //每个描述符集平均含该类描述符的个数
+        };
+        static constexpr poolSizeRatio defaultRatios[] = {
+            { VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.f },
+            { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 2.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.f },
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.f },
+            { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 0.5f }
+        };
+        static constexpr uint32_t maxSetsPerPool = 4096;
+    private:
+        std::vector<poolSizeRatio> ratios;
+        std::vector<descriptorPool> fullPools;  //已耗尽的池
+        std::vector<descriptorPool> readyPools; //尚可分配的池，末尾的为当前所用
+        uint32_t setsPerPool;
+        VkDescriptorPoolCreateFlags flags;
+
+        result_t CreatePool() {
+            std::vector<VkDescriptorPoolSize> poolSizes;
+            for (auto& [type, ratio] : ratios)
+                poolSizes.push_back({ type, std::max(uint32_t(ratio * setsPerPool), 1u) });
+            descriptorPool newPool;
+            if (VkResult result = newPool.Create(setsPerPool, { poolSizes.data(), poolSizes.size() }, flags))
+                return result;
+            readyPools.push_back(std::move(newPool));
+            setsPerPool = std::min(setsPerPool + setsPerPool / 2, maxSetsPerPool);
+            return VK_SUCCESS;
+        }
+    public:
+        //flags可为VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT（以便逐个释放）或VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT
+        descriptorAllocator(uint32_t initialSetsPerPool = 256, arrayRef<const poolSizeRatio> ratios = defaultRatios, VkDescriptorPoolCreateFlags flags = 0) :
+            ratios(ratios.begin(), ratios.end()), setsPerPool(std::clamp(initialSetsPerPool, 1u, maxSetsPerPool)), flags(flags) {}
+        descriptorAllocator(descriptorAllocator&&) = default;
+        descriptorAllocator& operator=(descriptorAllocator&&) = default;
+        //Getter
+        uint32_t PoolCount() const { return uint32_t(fullPools.size() + readyPools.size()); }
+        //Non-const Function
+        //pNext可接入VkDescriptorSetVariableDescriptorCountAllocateInfo等
+        result_t Allocate(VkDescriptorSet& set, VkDescriptorSetLayout setLayout, const void* pNext = nullptr) {
+            VkDescriptorSetAllocateInfo allocateInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+                .pNext = pNext,
+                .descriptorSetCount = 1,
+                .pSetLayouts = &setLayout
+            };
+            //至多换一次新池：新池也分配不了，说明比例或容量不适合该布局
+            for (uint32_t attempt = 0; attempt < 2; attempt++) {
+                if (readyPools.empty())
+                    if (VkResult result = CreatePool())
+                        return result;
+                allocateInfo.descriptorPool = readyPools.back();
+                VkResult result = vkAllocateDescriptorSets(graphicsBase::Base().Device(), &allocateInfo, &set);
+                if (result != VK_ERROR_OUT_OF_POOL_MEMORY &&
+                    result != VK_ERROR_FRAGMENTED_POOL) {
+                    if (result)
+                        outStream << std::format("[ descriptorAllocator ] ERROR\nFailed to allocate a descriptor set!\nError code: {}\n", int32_t(result));
+                    return result;
+                }
+                fullPools.push_back(std::move(readyPools.back()));
+                readyPools.pop_back();
+            }
+            outStream << std::format("[ descriptorAllocator ] ERROR\nA fresh descriptor pool cannot hold the set, check the pool size ratios!\n");
+            return VK_ERROR_OUT_OF_POOL_MEMORY;
+        }
+        VkDescriptorSet Allocate(VkDescriptorSetLayout setLayout, const void* pNext = nullptr) {
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            if (Allocate(set, setLayout, pNext))
+                return VK_NULL_HANDLE;
+            return set;
+        }
+        //重置所有池，由其分配的描述符集全部失效，调用前需确保它们不再被使用
+        result_t Reset() {
+            for (auto& i : readyPools)
+                if (VkResult result = i.Reset())
+                    return result;
+            for (auto& i : fullPools) {
+                if (VkResult result = i.Reset())
+                    return result;
+                readyPools.push_back(std::move(i));
+            }
+            fullPools.clear();
+            return VK_SUCCESS;
+        }
+    };
+
+    // 每个飞行中的帧一个descriptorAllocator，帧开始时整体重置该帧的池，帧内分配只是从池中取出，几乎没有开销
+    class frameDescriptorAllocator {
+        std::vector<descriptorAllocator> frames;
+        uint32_t currentFrame = 0;
+    public:
+        frameDescriptorAllocator(uint32_t framesInFlight = 2, uint32_t initialSetsPerPool = 256,
+            arrayRef<const descriptorAllocator::poolSizeRatio> ratios = descriptorAllocator::defaultRatios) {
+            frames.reserve(framesInFlight);
+            for (uint32_t i = 0; i < framesInFlight; i++)
+                frames.emplace_back(initialSetsPerPool, ratios);
+        }
+        frameDescriptorAllocator(frameDescriptorAllocator&&) = default;
+        //Getter
+        uint32_t CurrentFrame() const { return currentFrame; }
+        descriptorAllocator& Current() { return frames[currentFrame]; }
+        //Non-const Function
+        //切换到下一帧并重置其池，调用前需确保该帧的栅栏已被置位（比如在frameCommandAllocator::BeginFrame()之后调用）
+        result_t BeginFrame() {
+            currentFrame = (currentFrame + 1) % frames.size();
+            return frames[currentFrame].Reset();
+        }
+        //分配当帧的描述符集，下次轮到该帧时自动回收
+        result_t Allocate(VkDescriptorSet& set, VkDescriptorSetLayout setLayout, const void* pNext = nullptr) {
+            return frames[currentFrame].Allocate(set, setLayout, pNext);
+        }
+        VkDescriptorSet Allocate(VkDescriptorSetLayout setLayout, const void* pNext = nullptr) {
+            return frames[currentFrame].Allocate(setLayout, pNext);
+        }
+    };
+}
@@ -0,0 +1,254 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Descriptor Buffer Backend
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // VK_EXT_descriptor_buffer：描述符不再存于描述符池，而是由vkGetDescriptorEXT(...)直接写入host可见的缓冲区，着色器按（缓冲区地址+偏移）取用
+    // 可选的后端，与描述符池/描述符集不能混用于同一管线：所用的描述符集布局须由descriptorBufferLayout创建，管线须以VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT创建
+    // 需在创建逻辑设备前调用graphicsBase::RequestDescriptorBuffer()，以graphicsBase::DescriptorBufferAvailable()判断是否可用
+    struct descriptorBufferFunctions {
+        struct functions_t {
+            PFN_vkGetDescriptorSetLayoutSizeEXT vkGetDescriptorSetLayoutSizeEXT = DeviceProcAddr(vkGetDescriptorSetLayoutSizeEXT);
+            PFN_vkGetDescriptorSetLayoutBindingOffsetEXT vkGetDescriptorSetLayoutBindingOffsetEXT = DeviceProcAddr(vkGetDescriptorSetLayoutBindingOffsetEXT);
+            PFN_vkGetDescriptorEXT vkGetDescriptorEXT = DeviceProcAddr(vkGetDescriptorEXT);
+            PFN_vkCmdBindDescriptorBuffersEXT vkCmdBindDescriptorBuffersEXT = DeviceProcAddr(vkCmdBindDescriptorBuffersEXT);
+            PFN_vkCmdSetDescriptorBufferOffsetsEXT vkCmdSetDescriptorBufferOffsetsEXT = DeviceProcAddr(vkCmdSetDescriptorBufferOffsetsEXT);
+        };
+        static const functions_t& Functions() {
+            static const functions_t functions;
+            return functions;
+        }
+        //一个描述符在缓冲区中所占的字节数，启用了robustBufferAccess时，uniform/storage（texel）buffer的描述符取robust版本的大小
+        static size_t DescriptorSize(VkDescriptorType descriptorType) {
+            auto& properties = graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties();
+            bool robust = graphicsBase::Base().PhysicalDeviceFeatures().robustBufferAccess;
+            switch (descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER: return properties.samplerDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: return properties.combinedImageSamplerDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: return properties.sampledImageDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: return properties.storageImageDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: return properties.inputAttachmentDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER: return robust ? properties.robustUniformTexelBufferDescriptorSize : properties.uniformTexelBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: return robust ? properties.robustStorageTexelBufferDescriptorSize : properties.storageTexelBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: return robust ? properties.robustUniformBufferDescriptorSize : properties.uniformBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: return robust ? properties.robustStorageBufferDescriptorSize : properties.storageBufferDescriptorSize;
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR: return properties.accelerationStructureDescriptorSize;
+            default: return 0;
+            }
+        }
+    };
+
+    // 以VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT创建的描述符集布局，创建时一次性查询并缓存布局大小及各绑定的偏移
+    // 不支持动态偏移的缓冲区（UNIFORM/STORAGE_BUFFER_DYNAMIC），可用VkDescriptorAddressInfoEXT直接指定地址代替
+    // combinedImageSamplerDescriptorSingleArray为VK_FALSE时，combined image sampler数组在缓冲区中被拆为图像描述符数组及紧随其后的采样器描述符数组
+    class descriptorBufferLayout {
+        descriptorSetLayout setLayout;
+        VkDeviceSize size = 0;                      //已对齐到descriptorBufferOffsetAlignment
+        std::vector<VkDeviceSize> bindingOffsets;   //[binding]
+        std::vector<VkDescriptorType> bindingTypes; //[binding]
+        std::vector<uint32_t> bindingCounts;        //[binding]
+    public:
+        descriptorBufferLayout() = default;
+        descriptorBufferLayout(arrayRef<const VkDescriptorSetLayoutBinding> bindings) {
+            Create(bindings);
+        }
+        descriptorBufferLayout(descriptorBufferLayout&&) = default;
+        //Getter
+        VkDescriptorSetLayout SetLayout() const { return setLayout; }
+        VkDeviceSize Size() const { return size; }
+        //Const Function
+        //第binding个绑定的第arrayElement个描述符相对于描述符集起始处的偏移，被拆分的combined image sampler数组为其图像部分的偏移
+        VkDeviceSize Offset(uint32_t binding, uint32_t arrayElement = 0) const {
+            if (SplitsCombinedImageSampler(binding))
+                return bindingOffsets[binding] + arrayElement * graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties().sampledImageDescriptorSize;
+            return bindingOffsets[binding] + arrayElement * descriptorBufferFunctions::DescriptorSize(bindingTypes[binding]);
+        }
+        //被拆分的combined image sampler数组中，第arrayElement个描述符的采样器部分的偏移
+        VkDeviceSize SamplerOffset(uint32_t binding, uint32_t arrayElement = 0) const {
+            auto& properties = graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties();
+            return bindingOffsets[binding] + bindingCounts[binding] * properties.sampledImageDescriptorSize + arrayElement * properties.samplerDescriptorSize;
+        }
+        bool SplitsCombinedImageSampler(uint32_t binding) const {
+            return bindingTypes[binding] == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER && bindingCounts[binding] > 1 &&
+                !graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties().combinedImageSamplerDescriptorSingleArray;
+        }
+        VkDescriptorType Type(uint32_t binding) const { return bindingTypes[binding]; }
+        //Non-const Function
+        result_t Create(arrayRef<const VkDescriptorSetLayoutBinding> bindings) {
+            VkDescriptorSetLayoutCreateInfo createInfo = {
+                .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT,
+                .bindingCount = uint32_t(bindings.Count()),
+                .pBindings = bindings.Pointer()
+            };
+            if (VkResult result = setLayout.Create(createInfo))
+                return result;
+            auto& functions = descriptorBufferFunctions::Functions();
+            VkDevice device = graphicsBase::Base().Device();
+            VkDeviceSize alignment = graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties().descriptorBufferOffsetAlignment;
+            functions.vkGetDescriptorSetLayoutSizeEXT(device, setLayout, &size);
+            size = (size + alignment - 1) / alignment * alignment;
+            bindingOffsets.clear();
+            bindingTypes.clear();
+            bindingCounts.clear();
+            for (auto& i : bindings) {
+                if (i.binding >= bindingOffsets.size())
+                    bindingOffsets.resize(i.binding + 1),
+                    bindingTypes.resize(i.binding + 1, VK_DESCRIPTOR_TYPE_MAX_ENUM),
+                    bindingCounts.resize(i.binding + 1);
+                functions.vkGetDescriptorSetLayoutBindingOffsetEXT(device, setLayout, i.binding, &bindingOffsets[i.binding]);
+                bindingTypes[i.binding] = i.descriptorType;
+                bindingCounts[i.binding] = i.descriptorCount;
+            }
+            return VK_SUCCESS;
+        }
+    };
+
+    // 持久映射的描述符缓冲区，每个飞行中的帧占其中一段，帧内为描述符集“分配”空间只是移动偏移量
+    // 每个命令缓冲区开始时CmdBindBuffer(...)一次，之后切换材质只需CmdSetOffset(...)，不经驱动分配或更新描述符集
+    // framesInFlight为1且不调用BeginFrame()时，可用作长期存在的描述符集的线性分配器
+    class descriptorBuffer {
+        bufferMemory descriptorStorage;
+        uint8_t* pMapped = nullptr;
+        VkDeviceAddress address = 0;
+        VkDeviceSize capacityPerFrame = 0;
+        VkDeviceSize frameBegin = 0;
+        VkDeviceSize used = 0;
+        uint32_t framesInFlight = 0;
+        uint32_t currentFrame = 0;
+        VkBufferUsageFlags usage = 0;
+
+        void Write(VkDeviceSize offset, const VkDescriptorGetInfoEXT& getInfo) const {
+            size_t size = descriptorBufferFunctions::DescriptorSize(getInfo.type);
+            descriptorBufferFunctions::Functions().vkGetDescriptorEXT(graphicsBase::Base().Device(), &getInfo, size, pMapped + offset);
+        }
+    public:
+        descriptorBuffer() = default;
+        descriptorBuffer(VkDeviceSize capacityPerFrame, uint32_t framesInFlight = 2) {
+            Create(capacityPerFrame, framesInFlight);
+        }
+        descriptorBuffer(descriptorBuffer&&) = default;
+        //Getter
+        VkDeviceAddress Address() const { return address; }
+        //当帧已用的字节数
+        VkDeviceSize Used() const { return used; }
+        //Const Function
+        //将缓冲区绑定为第0个描述符缓冲区，每个命令缓冲区调用一次
+        void CmdBindBuffer(VkCommandBuffer commandBuffer) const {
+            VkDescriptorBufferBindingInfoEXT bindingInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT,
+                .address = address,
+                .usage = usage
+            };
+            descriptorBufferFunctions::Functions().vkCmdBindDescriptorBuffersEXT(commandBuffer, 1, &bindingInfo);
+        }
+        //令layout的第set个描述符集取用缓冲区中setOffset（Allocate(...)的返回值）处的描述符
+        void CmdSetOffset(VkCommandBuffer commandBuffer, VkPipelineBindPoint bindPoint, VkPipelineLayout layout, uint32_t set, VkDeviceSize setOffset) const {
+            uint32_t bufferIndex = 0;
+            descriptorBufferFunctions::Functions().vkCmdSetDescriptorBufferOffsetsEXT(commandBuffer, bindPoint, layout, set, 1, &bufferIndex, &setOffset);
+        }
+        //以下Write*(...)将描述符写入setOffset处的描述符集中，layout为该描述符集的布局
+        void WriteImage(VkDeviceSize setOffset, const descriptorBufferLayout& layout, uint32_t binding, const VkDescriptorImageInfo& imageInfo, uint32_t arrayElement = 0) const {
+            VkDescriptorGetInfoEXT getInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = layout.Type(binding)
+            };
+            switch (getInfo.type) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER: getInfo.data.pSampler = &imageInfo.sampler; break;
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: getInfo.data.pCombinedImageSampler = &imageInfo; break;
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE: getInfo.data.pSampledImage = &imageInfo; break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE: getInfo.data.pStorageImage = &imageInfo; break;
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT: getInfo.data.pInputAttachmentImage = &imageInfo; break;
+            default:
+                outStream << std::format("[ descriptorBuffer ] ERROR\nBinding {} is not an image or sampler binding!\n", binding);
+                return;
+            }
+            if (layout.SplitsCombinedImageSampler(binding)) {
+                //取得的描述符中，前sampledImageDescriptorSize字节写入图像数组，其余写入采样器数组
+                auto& properties = graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties();
+                std::vector<uint8_t> descriptor(properties.combinedImageSamplerDescriptorSize);
+                descriptorBufferFunctions::Functions().vkGetDescriptorEXT(graphicsBase::Base().Device(), &getInfo, descriptor.size(), descriptor.data());
+                memcpy(pMapped + setOffset + layout.Offset(binding, arrayElement), descriptor.data(), properties.sampledImageDescriptorSize);
+                memcpy(pMapped + setOffset + layout.SamplerOffset(binding, arrayElement),
+                    descriptor.data() + properties.sampledImageDescriptorSize, properties.samplerDescriptorSize);
+                return;
+            }
+            Write(setOffset + layout.Offset(binding, arrayElement), getInfo);
+        }
+        //用于uniform/storage buffer及texel buffer（须指定format），缓冲区的地址可由bufferMemory::DeviceAddress()取得
+        void WriteBuffer(VkDeviceSize setOffset, const descriptorBufferLayout& layout, uint32_t binding, VkDeviceAddress bufferAddress, VkDeviceSize range,
+            uint32_t arrayElement = 0, VkFormat format = VK_FORMAT_UNDEFINED) const {
+            VkDescriptorAddressInfoEXT addressInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT,
+                .address = bufferAddress,
+                .range = range,
+                .format = format
+            };
+            VkDescriptorGetInfoEXT getInfo = {
+                .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT,
+                .type = layout.Type(binding)
+            };
+            switch (getInfo.type) {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER: getInfo.data.pUniformBuffer = &addressInfo; break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER: getInfo.data.pStorageBuffer = &addressInfo; break;
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER: getInfo.data.pUniformTexelBuffer = &addressInfo; break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER: getInfo.data.pStorageTexelBuffer = &addressInfo; break;
+            default:
+                outStream << std::format("[ descriptorBuffer ] ERROR\nBinding {} is not a buffer binding!\n", binding);
+                return;
+            }
+            Write(setOffset + layout.Offset(binding, arrayElement), getInfo);
+        }
+        //Non-const Function
+        //为一个布局为layout的描述符集分配当帧的空间，返回其在缓冲区中的偏移，空间不足时返回VK_WHOLE_SIZE
+        VkDeviceSize Allocate(const descriptorBufferLayout& layout) {
+            if (used + layout.Size() > capacityPerFrame) {
+                outStream << std::format("[ descriptorBuffer ] ERROR\nOut of descriptor buffer space, capacity per frame: {}!\n", capacityPerFrame);
+                return VK_WHOLE_SIZE;
+            }
+            VkDeviceSize setOffset = frameBegin + used;
+            used += layout.Size();
+            return setOffset;
+        }
+        //切换到下一帧，该帧此前写入的描述符作废，调用前需确保该帧的栅栏已被置位
+        void BeginFrame() {
+            currentFrame = (currentFrame + 1) % framesInFlight;
+            frameBegin = currentFrame * capacityPerFrame;
+            used = 0;
+        }
+        //缓冲区同时用于采样器和资源描述符，总大小被限制在设备允许的范围内
+        result_t Create(VkDeviceSize capacityPerFrame, uint32_t framesInFlight = 2) {
+            if (!graphicsBase::Base().DescriptorBufferAvailable()) {
+                outStream << std::format("[ descriptorBuffer ] ERROR\nVK_EXT_descriptor_buffer is not available!\n");
+                return VK_ERROR_FEATURE_NOT_PRESENT;
+            }
+            auto& properties = graphicsBase::Base().PhysicalDeviceDescriptorBufferProperties();
+            VkDeviceSize alignment = properties.descriptorBufferOffsetAlignment;
+            VkDeviceSize maxRange = std::min(properties.maxSamplerDescriptorBufferRange, properties.maxResourceDescriptorBufferRange);
+            capacityPerFrame = std::min(capacityPerFrame, maxRange / framesInFlight);
+            this->capacityPerFrame = capacityPerFrame / alignment * alignment;
+            this->framesInFlight = framesInFlight;
+            currentFrame = 0;
+            frameBegin = used = 0;
+            usage =
+                VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+            VkBufferCreateInfo createInfo = {
+                .size = this->capacityPerFrame * framesInFlight,
+                .usage = usage
+            };
+            if (VkResult result = descriptorStorage.Create(createInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+                return result;
+            void* pData;
+            if (VkResult result = descriptorStorage.MapMemory(pData, VK_WHOLE_SIZE))
+                return result;
+            pMapped = static_cast<uint8_t*>(pData);
+            address = descriptorStorage.DeviceAddress();
+            return VK_SUCCESS;
+        }
+    };
+}
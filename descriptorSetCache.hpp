@@ -0,0 +1,177 @@
+#pragma once
+
+#include "descriptorAllocator.hpp"
+
+// Descriptor Set Cache
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 以（描述符集布局, 所绑定的各资源及其范围）为键缓存描述符集，内容相同的描述符集在帧内及跨帧复用，不必重复分配和写入
+    // 缓存的描述符集多于capacity时，在BeginFrame()中按最近使用的帧淘汰，仍可能被飞行中的帧使用的描述符集不会被淘汰
+    // 淘汰的描述符集不释放，留待同一布局的新内容改写后再用
+    // 资源被销毁后，其句柄值可能被新资源重用，此时须调用Clear()，以免命中内容已失效的描述符集
+    class descriptorSetCache {
+    public:
+        struct statistics {
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+            uint64_t evictions = 0;
+        };
+        // 描述符集的内容，即各绑定处的资源，以Image(...)等依次添加，同一内容应以相同的顺序添加
+        class resources {
+            friend class descriptorSetCache;
+            struct element {
+                uint32_t binding;
+                uint32_t arrayElement;
+                VkDescriptorType type;
+                VkDescriptorImageInfo imageInfo = {};
+                VkDescriptorBufferInfo bufferInfo = {};
+                VkBufferView texelBufferView = VK_NULL_HANDLE;
+            };
+            std::vector<element> elements;
+        public:
+            resources& Image(uint32_t binding, VkDescriptorType type, const VkDescriptorImageInfo& imageInfo, uint32_t arrayElement = 0) {
+                elements.push_back({ binding, arrayElement, type, imageInfo });
+                return *this;
+            }
+            resources& Buffer(uint32_t binding, VkDescriptorType type, const VkDescriptorBufferInfo& bufferInfo, uint32_t arrayElement = 0) {
+                elements.push_back({ binding, arrayElement, type, {}, bufferInfo });
+                return *this;
+            }
+            resources& TexelBuffer(uint32_t binding, VkDescriptorType type, VkBufferView bufferView, uint32_t arrayElement = 0) {
+                elements.push_back({ binding, arrayElement, type, {}, {}, bufferView });
+                return *this;
+            }
+            void Clear() { elements.clear(); }
+        };
+    private:
+        struct entry {
+            std::vector<uint8_t> key; //完整的键，用于排除散列冲突
+            VkDescriptorSetLayout setLayout;
+            VkDescriptorSet set;
+            uint64_t lastUsedFrame;
+        };
+        std::mutex mutex;
+        descriptorAllocator allocator;
+        std::unordered_multimap<uint64_t, entry> entries;
+        std::unordered_map<VkDescriptorSetLayout, std::vector<VkDescriptorSet>> evictedSets; //[布局][已淘汰的描述符集]
+        statistics stats;
+        uint64_t currentFrame = 0;
+        uint32_t capacity;
+        uint32_t framesInFlight;
+
+        template<typename T>
+        static void Append(std::vector<uint8_t>& key, const T& data) {
+            key.insert(key.end(), reinterpret_cast<const uint8_t*>(&data), reinterpret_cast<const uint8_t*>(&data) + sizeof data);
+        }
+        //逐个成员序列化，不含结构体中的填充字节
+        static std::vector<uint8_t> Key(VkDescriptorSetLayout setLayout, const resources& contents) {
+            std::vector<uint8_t> key;
+            key.reserve(sizeof setLayout + contents.elements.size() * 48);
+            Append(key, setLayout);
+            for (auto& i : contents.elements) {
+                Append(key, i.binding);
+                Append(key, i.arrayElement);
+                Append(key, i.type);
+                if (i.texelBufferView)
+                    Append(key, i.texelBufferView);
+                else if (i.bufferInfo.buffer)
+                    Append(key, i.bufferInfo.buffer),
+                    Append(key, i.bufferInfo.offset),
+                    Append(key, i.bufferInfo.range);
+                else
+                    Append(key, i.imageInfo.sampler),
+                    Append(key, i.imageInfo.imageView),
+                    Append(key, i.imageInfo.imageLayout);
+            }
+            return key;
+        }
+        static void Write(VkDescriptorSet set, const resources& contents) {
+            std::vector<VkWriteDescriptorSet> writes;
+            writes.reserve(contents.elements.size());
+            for (auto& i : contents.elements)
+                writes.push_back({
+                    .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+                    .dstSet = set,
+                    .dstBinding = i.binding,
+                    .dstArrayElement = i.arrayElement,
+                    .descriptorCount = 1,
+                    .descriptorType = i.type,
+                    .pImageInfo = &i.imageInfo,
+                    .pBufferInfo = &i.bufferInfo,
+                    .pTexelBufferView = &i.texelBufferView });
+            vkUpdateDescriptorSets(graphicsBase::Base().Device(), uint32_t(writes.size()), writes.data(), 0, nullptr);
+        }
+        void Evict() {
+            if (entries.size() <= capacity)
+                return;
+            std::vector<decltype(entries)::iterator> candidates;
+            for (auto iterator = entries.begin(); iterator != entries.end(); ++iterator)
+                if (iterator->second.lastUsedFrame + framesInFlight <= currentFrame)
+                    candidates.push_back(iterator);
+            size_t evictionCount = std::min(entries.size() - capacity, candidates.size());
+            std::nth_element(candidates.begin(), candidates.begin() + evictionCount, candidates.end(),
+                [](auto& a, auto& b) { return a->second.lastUsedFrame < b->second.lastUsedFrame; });
+            for (size_t i = 0; i < evictionCount; i++)
+                evictedSets[candidates[i]->second.setLayout].push_back(candidates[i]->second.set),
+                entries.erase(candidates[i]);
+            stats.evictions += evictionCount;
+        }
+    public:
+        descriptorSetCache(uint32_t capacity = 4096, uint32_t framesInFlight = 2,
+            arrayRef<const descriptorAllocator::poolSizeRatio> ratios = descriptorAllocator::defaultRatios) :
+            allocator(std::min(capacity, descriptorAllocator::maxSetsPerPool), ratios), capacity(capacity), framesInFlight(framesInFlight) {}
+        descriptorSetCache(descriptorSetCache&&) = delete;
+        //Getter
+        size_t Count() {
+            std::lock_guard lock(mutex);
+            return entries.size();
+        }
+        statistics Statistics() {
+            std::lock_guard lock(mutex);
+            return stats;
+        }
+        //Non-const Function
+        void ResetStatistics() {
+            std::lock_guard lock(mutex);
+            stats = {};
+        }
+        //取得内容为contents的描述符集，不存在时分配（或改写已淘汰的）并写入，失败时返回VK_NULL_HANDLE
+        VkDescriptorSet Get(VkDescriptorSetLayout setLayout, const resources& contents) {
+            std::vector<uint8_t> key = Key(setLayout, contents);
+            uint64_t hash = HashBytes(key.data(), key.size());
+            std::lock_guard lock(mutex);
+            auto [begin, end] = entries.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (iterator->second.key == key) {
+                    stats.hits++;
+                    iterator->second.lastUsedFrame = currentFrame;
+                    return iterator->second.set;
+                }
+            stats.misses++;
+            VkDescriptorSet set = VK_NULL_HANDLE;
+            if (auto& sets = evictedSets[setLayout]; sets.size())
+                set = sets.back(),
+                sets.pop_back();
+            else if (allocator.Allocate(set, setLayout))
+                return VK_NULL_HANDLE;
+            Write(set, contents);
+            entries.emplace(hash, entry{ std::move(key), setLayout, set, currentFrame });
+            return set;
+        }
+        //在每帧开始时调用，调用前需确保framesInFlight帧前的命令已执行完毕
+        void BeginFrame() {
+            std::lock_guard lock(mutex);
+            currentFrame++;
+            Evict();
+        }
+        //清空缓存并重置所有池，调用前需确保描述符集不再被使用
+        result_t Clear() {
+            std::lock_guard lock(mutex);
+            entries.clear();
+            evictedSets.clear();
+            return allocator.Reset();
+        }
+    };
+}
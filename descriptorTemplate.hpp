@@ -0,0 +1,179 @@
+#pragma once
+
+#include "descriptorAllocator.hpp"
+#include "spirvReflection.hpp"
+
+// Descriptor Update Templates
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 由描述符集布局的各绑定（或着色器反射结果）生成描述符更新模板，之后以一个普通结构体一次写入整个描述符集
+    // 结构体的成员须按binding从小到大排列，每个绑定一个成员，依描述符类型为VkDescriptorImageInfo、VkDescriptorBufferInfo、VkBufferView，或长度为descriptorCount的相应数组
+    // 这几种类型都按8字节对齐，结构体中不会有填充，各成员的偏移即其前各成员大小之和，模板据此生成，更新时检查结构体的大小是否一致
+    // 例：binding 0为uniform buffer，binding 1为2个combined image sampler
+    //     struct materialDescriptors { VkDescriptorBufferInfo constants; VkDescriptorImageInfo textures[2]; };
+    // 启用了VK_KHR_push_descriptor时默认以推送方式绑定，描述符直接记入命令缓冲区，不必分配描述符集，适合每次绘制都不同的少量描述符
+    // 不能推送时（扩展不可用、描述符个数超出上限、含动态偏移的缓冲区），从frameDescriptorAllocator分配当帧的描述符集，以模板写入后绑定
+    // 推送模板与管线布局及描述符集编号相关，按（管线布局, 描述符集编号）在首次以其绑定时创建，管线布局销毁后其句柄值若被重用，须重新Create(...)
+    class descriptorTemplate {
+        descriptorSetLayout setLayout;
+        descriptorUpdateTemplate updateTemplate; //非推送方式的模板
+        std::map<std::pair<VkPipelineLayout, uint32_t>, descriptorUpdateTemplate> pushTemplates;
+        std::vector<VkDescriptorUpdateTemplateEntry> entries;
+        VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        size_t dataSize = 0;
+        uint32_t dynamicDescriptorCount = 0;
+        bool push = false;
+
+        bool CheckSize(size_t size) const {
+            if (size == dataSize)
+                return true;
+            outStream << std::format("[ descriptorTemplate ] ERROR\nSize of the descriptor data is {}, but the template expects {}!\n", size, dataSize);
+            return false;
+        }
+        //推送模板须指定管线布局，在首次以（layout, set）绑定时才创建
+        const descriptorUpdateTemplate* PushTemplate(VkPipelineLayout layout, uint32_t set) {
+            auto& pushTemplate = pushTemplates[{ layout, set }];
+            if (pushTemplate)
+                return &pushTemplate;
+            VkDescriptorUpdateTemplateCreateInfo createInfo = {
+                .descriptorUpdateEntryCount = uint32_t(entries.size()),
+                .pDescriptorUpdateEntries = entries.data(),
+                .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR,
+                .pipelineBindPoint = bindPoint,
+                .pipelineLayout = layout,
+                .set = set
+            };
+            if (pushTemplate.Create(createInfo)) {
+                pushTemplates.erase({ layout, set });
+                return nullptr;
+            }
+            return &pushTemplate;
+        }
+    public:
+        descriptorTemplate() = default;
+        descriptorTemplate(std::span<const VkDescriptorSetLayoutBinding> bindings, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS, bool preferPush = true) {
+            Create(bindings, bindPoint, preferPush);
+        }
+        descriptorTemplate(const shaderReflection& reflection, uint32_t set, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS, bool preferPush = true) {
+            Create(reflection, set, bindPoint, preferPush);
+        }
+        descriptorTemplate(descriptorTemplate&&) = default;
+        //Getter
+        //用于创建管线布局，推送方式下该布局带VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR
+        VkDescriptorSetLayout SetLayout() const { return setLayout; }
+        bool IsPush() const { return push; }
+        size_t DataSize() const { return dataSize; }
+        //Const Function
+        //以模板写入一个长期存在的描述符集，仅适用于非推送方式
+        template<typename T>
+        void Update(VkDescriptorSet set, const T& data) const {
+            if (push) {
+                outStream << std::format("[ descriptorTemplate ] ERROR\nA push descriptor template cannot update descriptor sets!\n");
+                return;
+            }
+            if (CheckSize(sizeof data))
+                updateTemplate.Update(set, &data);
+        }
+        //Non-const Function
+        //将data中的描述符绑定到layout的第set个描述符集，layout的该描述符集布局须为SetLayout()
+        //非推送方式下allocator须已为当帧调用过BeginFrame()
+        //含动态偏移的缓冲区时，dynamicOffsets须按binding顺序为每个这样的描述符提供一个偏移（此时总是非推送方式）
+        template<typename T>
+        result_t CmdBind(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t set, const T& data, frameDescriptorAllocator& allocator,
+            arrayRef<const uint32_t> dynamicOffsets = {}) {
+            if (!CheckSize(sizeof data))
+                return VK_RESULT_MAX_ENUM;
+            if (dynamicOffsets.Count() != dynamicDescriptorCount) {
+                outStream << std::format("[ descriptorTemplate ] ERROR\nExpected {} dynamic offsets, but {} are provided!\n", dynamicDescriptorCount, dynamicOffsets.Count());
+                return VK_RESULT_MAX_ENUM;
+            }
+            if (push) {
+                auto pPushTemplate = PushTemplate(layout, set);
+                if (!pPushTemplate)
+                    return VK_RESULT_MAX_ENUM;
+                pPushTemplate->CmdPush(commandBuffer, layout, set, &data);
+                return VK_SUCCESS;
+            }
+            VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+            if (VkResult result = allocator.Allocate(descriptorSet, setLayout))
+                return result;
+            updateTemplate.Update(descriptorSet, &data);
+            vkCmdBindDescriptorSets(commandBuffer, bindPoint, layout, set, 1, &descriptorSet, uint32_t(dynamicOffsets.Count()), dynamicOffsets.Pointer());
+            return VK_SUCCESS;
+        }
+        result_t Create(std::span<const VkDescriptorSetLayoutBinding> bindings, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS, bool preferPush = true) {
+            std::vector<VkDescriptorSetLayoutBinding> sortedBindings(bindings.begin(), bindings.end());
+            std::ranges::sort(sortedBindings, {}, &VkDescriptorSetLayoutBinding::binding);
+            this->bindPoint = bindPoint;
+            entries.clear();
+            dataSize = 0;
+            uint32_t descriptorCount = 0;
+            dynamicDescriptorCount = 0;
+            for (auto& i : sortedBindings) {
+                uint32_t size = DescriptorInfoSize(i.descriptorType);
+                if (!size || !i.descriptorCount) {
+                    outStream << std::format("[ descriptorTemplate ] ERROR\nBinding {} cannot be written with a template, descriptor type: {}, count: {}!\n",
+                        i.binding, int32_t(i.descriptorType), i.descriptorCount);
+                    return VK_RESULT_MAX_ENUM;
+                }
+                entries.push_back({ i.binding, 0, i.descriptorCount, i.descriptorType, dataSize, size });
+                dataSize += size_t(size) * i.descriptorCount;
+                descriptorCount += i.descriptorCount;
+                if (i.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+                    i.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
+                    dynamicDescriptorCount += i.descriptorCount;
+            }
+            auto& base = graphicsBase::Base();
+            push = preferPush && !dynamicDescriptorCount &&
+                base.PushDescriptorAvailable() &&
+                descriptorCount <= base.PhysicalDevicePushDescriptorProperties().maxPushDescriptors;
+            VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {
+                .flags = push ? VkDescriptorSetLayoutCreateFlags(VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR) : 0,
+                .bindingCount = uint32_t(sortedBindings.size()),
+                .pBindings = sortedBindings.data()
+            };
+            if (VkResult result = setLayout.Create(setLayoutCreateInfo))
+                return result;
+            updateTemplate = descriptorUpdateTemplate();
+            pushTemplates.clear();
+            if (push)
+                return VK_SUCCESS;
+            VkDescriptorUpdateTemplateCreateInfo createInfo = {
+                .descriptorUpdateEntryCount = uint32_t(entries.size()),
+                .pDescriptorUpdateEntries = entries.data(),
+                .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+                .descriptorSetLayout = setLayout
+            };
+            return updateTemplate.Create(createInfo);
+        }
+        result_t Create(const shaderReflection& reflection, uint32_t set, VkPipelineBindPoint bindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS, bool preferPush = true) {
+            return Create(reflection.SetLayoutBindings(set), bindPoint, preferPush);
+        }
+        //Static Function
+        //模板数据中一个描述符所占的字节数，为0表示该类描述符不能以此方式写入
+        static uint32_t DescriptorInfoSize(VkDescriptorType descriptorType) {
+            switch (descriptorType) {
+            case VK_DESCRIPTOR_TYPE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+            case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+                return sizeof(VkDescriptorImageInfo);
+            case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+                return sizeof(VkBufferView);
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                return sizeof(VkDescriptorBufferInfo);
+            case VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR:
+                return sizeof(VkAccelerationStructureKHR);
+            default:
+                return 0;
+            }
+        }
+    };
+}
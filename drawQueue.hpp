@@ -0,0 +1,177 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "threadPool.hpp"
+#include "commandEncoder.hpp"
+
+// Sort-key Draw Queue
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 每个绘制包带一个64位排序键，录制前以基数排序（LSD，8位一趟）排序，再经commandEncoder依次录制
+    // 不透明物体的键依次为通道、管线、材质、深度（由近到远），管线和描述符集的切换最少，同一材质内由近到远以利于early-Z
+    // 半透明物体的键依次为通道、深度（由远到近）、管线、材质，以保证混合顺序正确
+    // 数量多时排序在线程池上并行：各线程统计自己那一段的直方图，求出各段在各桶中的起始位置后并行分散写入，结果与串行的稳定排序一致
+    class drawQueue {
+    public:
+        struct drawPacket {
+            uint32_t pipelineId;                       //RegisterPipeline(...)的返回值
+            VkDescriptorSet materialSet = VK_NULL_HANDLE;
+            VkBuffer vertexBuffer = VK_NULL_HANDLE;
+            VkDeviceSize vertexBufferOffset = 0;
+            VkBuffer indexBuffer = VK_NULL_HANDLE;     //为VK_NULL_HANDLE时以vkCmdDraw(...)绘制
+            VkDeviceSize indexBufferOffset = 0;
+            VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+            uint32_t count = 0;                        //索引数或顶点数
+            uint32_t instanceCount = 1;
+            uint32_t first = 0;                        //首个索引或顶点
+            int32_t vertexOffset = 0;
+            uint32_t firstInstance = 0;
+        };
+        static constexpr uint32_t maxPassCount = 1 << 4;
+        static constexpr uint32_t maxPipelineCount = 1 << 12;
+        static constexpr uint32_t maxMaterialCount = 1 << 16;
+    private:
+        struct sortEntry {
+            uint64_t key;
+            uint32_t index;
+        };
+        struct pipelineEntry {
+            VkPipeline entryPipeline;
+            VkPipelineLayout layout;
+            std::vector<VkDynamicState> dynamicStates;
+        };
+        threadPool* pWorkers = nullptr;
+        uint32_t materialSetIndex = 0;
+        uint32_t parallelThreshold;
+        std::vector<pipelineEntry> pipelines;
+        std::vector<drawPacket> packets;
+        std::vector<sortEntry> entries;
+        std::vector<sortEntry> scratch;
+        std::vector<std::array<uint32_t, 256>> histograms;
+
+        //非负浮点数的位模式与其大小同序，负的深度（在近平面之前）视为0
+        static uint32_t DepthBits(float depth) {
+            depth = std::max(depth, 0.f);
+            uint32_t bits;
+            memcpy(&bits, &depth, 4);
+            return bits;
+        }
+        //将[0, count)分成chunkCount段，调用function(chunk, begin, end)，除最后一段外均提交到线程池
+        template<typename F>
+        void ParallelFor(uint32_t chunkCount, size_t count, F&& function) {
+            size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+            std::vector<std::future<void>> futures;
+            for (uint32_t i = 0; i + 1 < chunkCount; i++)
+                futures.push_back(pWorkers->Submit([&function, i, chunkSize, count] {
+                    function(i, std::min(i * chunkSize, count), std::min((i + 1) * chunkSize, count));
+                }));
+            function(chunkCount - 1, std::min((chunkCount - 1) * chunkSize, count), count);
+            for (auto& i : futures)
+                i.get();
+        }
+    public:
+        //workers为nullptr时总是串行排序，packetCount不少于parallelThreshold时才并行
+        drawQueue(threadPool* pWorkers = nullptr, uint32_t materialSetIndex = 0, uint32_t parallelThreshold = 1 << 16) :
+            pWorkers(pWorkers), materialSetIndex(materialSetIndex), parallelThreshold(parallelThreshold) {}
+        drawQueue(drawQueue&&) = default;
+        //Getter
+        size_t PacketCount() const { return packets.size(); }
+        //Const Function
+        //依次录制排好序的绘制包，管线、描述符集、顶点/索引缓冲区的冗余绑定由encoder略去
+        void Record(commandEncoder& encoder) const {
+            for (auto& [key, index] : entries) {
+                auto& packet = packets[index];
+                auto& [entryPipeline, layout, dynamicStates] = pipelines[packet.pipelineId];
+                encoder.BindPipeline(VK_PIPELINE_BIND_POINT_GRAPHICS, entryPipeline, { dynamicStates.data(), dynamicStates.size() });
+                if (packet.materialSet)
+                    encoder.BindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, layout, materialSetIndex, packet.materialSet);
+                if (packet.vertexBuffer)
+                    encoder.BindVertexBuffers(0, packet.vertexBuffer, packet.vertexBufferOffset);
+                if (packet.indexBuffer)
+                    encoder.BindIndexBuffer(packet.indexBuffer, packet.indexBufferOffset, packet.indexType),
+                    vkCmdDrawIndexed(encoder, packet.count, packet.instanceCount, packet.first, packet.vertexOffset, packet.firstInstance);
+                else
+                    vkCmdDraw(encoder, packet.count, packet.instanceCount, packet.first, packet.firstInstance);
+            }
+        }
+        //Non-const Function
+        //登记管线，返回用于排序键和drawPacket的管线ID，dynamicStates同commandEncoder::BindPipeline(...)
+        uint32_t RegisterPipeline(const pipeline& drawPipeline, const pipelineLayout& layout, arrayRef<const VkDynamicState> dynamicStates = {}) {
+            if (pipelines.size() == maxPipelineCount) {
+                outStream << std::format("[ drawQueue ] ERROR\nToo many pipelines, at most {} can be registered!\n", maxPipelineCount);
+                abort();
+            }
+            pipelines.push_back({ drawPipeline, layout, { dynamicStates.begin(), dynamicStates.end() } });
+            return uint32_t(pipelines.size() - 1);
+        }
+        void Reserve(size_t packetCount) {
+            packets.reserve(packetCount);
+            entries.reserve(packetCount);
+        }
+        //提交一个绘制包，非线程安全
+        void Submit(uint64_t key, const drawPacket& packet) {
+            entries.push_back({ key, uint32_t(packets.size()) });
+            packets.push_back(packet);
+        }
+        //按键排序，键相同的绘制包保持提交顺序
+        void Sort() {
+            size_t count = entries.size();
+            if (count < 2)
+                return;
+            //只对各键间有差异的字节排序，比如只有一个通道时最高字节那一趟可以省去
+            uint64_t varyingBits = 0;
+            for (auto& i : entries)
+                varyingBits |= i.key ^ entries[0].key;
+            uint32_t chunkCount = pWorkers && count >= parallelThreshold ? std::max(pWorkers->ThreadCount(), 1u) + 1 : 1;
+            scratch.resize(count);
+            histograms.resize(chunkCount);
+            for (uint32_t shift = 0; shift < 64; shift += 8) {
+                if (!(varyingBits >> shift & 0xff))
+                    continue;
+                auto countDigits = [&](uint32_t chunk, size_t begin, size_t end) {
+                    auto& histogram = histograms[chunk];
+                    histogram.fill(0);
+                    for (size_t i = begin; i < end; i++)
+                        histogram[entries[i].key >> shift & 0xff]++;
+                };
+                //各段在各桶中的起始位置：桶按数字排列，桶内按段排列
+                auto scatter = [&](uint32_t chunk, size_t begin, size_t end) {
+                    auto& offsets = histograms[chunk];
+                    for (size_t i = begin; i < end; i++)
+                        scratch[offsets[entries[i].key >> shift & 0xff]++] = entries[i];
+                };
+                if (chunkCount > 1)
+                    ParallelFor(chunkCount, count, countDigits);
+                else
+                    countDigits(0, 0, count);
+                uint32_t offset = 0;
+                for (uint32_t digit = 0; digit < 256; digit++)
+                    for (auto& histogram : histograms) {
+                        uint32_t digitCount = histogram[digit];
+                        histogram[digit] = offset;
+                        offset += digitCount;
+                    }
+                if (chunkCount > 1)
+                    ParallelFor(chunkCount, count, scatter);
+                else
+                    scatter(0, 0, count);
+                entries.swap(scratch);
+            }
+        }
+        //清空绘制包，保留已登记的管线和已分配的内存，在每帧开始时调用
+        void Clear() {
+            packets.clear();
+            entries.clear();
+        }
+        //Static Function
+        //depth为观察空间中到相机的距离
+        static uint64_t OpaqueKey(uint32_t pass, uint32_t pipelineId, uint32_t materialId, float depth) {
+            return uint64_t(pass & 0xf) << 60 | uint64_t(pipelineId & 0xfff) << 48 | uint64_t(materialId & 0xffff) << 32 | DepthBits(depth);
+        }
+        static uint64_t TranslucentKey(uint32_t pass, uint32_t pipelineId, uint32_t materialId, float depth) {
+            return uint64_t(pass & 0xf) << 60 | uint64_t(~DepthBits(depth)) << 28 | uint64_t(pipelineId & 0xfff) << 16 | (materialId & 0xffff);
+        }
+    };
+}
@@ -16,10 +16,7 @@ namespace easyVulkan {
     };
 
     // һֱȾͼҲȲԵκβԵrender pass
-    const auto& CreateRpwf_Screen() {
-        static renderPassWithFramebuffers rpwf;
-
-        // ===== render pass =========
+    inline result_t CreateRenderPass_Screen(renderPass& renderPass) {
         // ͼ񸽼
         VkAttachmentDescription attachmentDescription = {
             .format = graphicsBase::Base().SwapchainCreateInfo().imageFormat, // ǽͼ
@@ -57,7 +54,15 @@ namespace easyVulkan {
         .dependencyCount = 1,
         .pDependencies = &subpassDependency
         };
-        rpwf.renderPass.Create(renderPassCreateInfo);
+        return renderPass.Create(renderPassCreateInfo);
+    }
+
+    // render passΪÿŽͼ񴴽֡
+    const auto& CreateRpwf_Screen() {
+        static renderPassWithFramebuffers rpwf;
+
+        // ===== render pass =========
+        CreateRenderPass_Screen(rpwf.renderPass);
 
         // ===== framebuffers =========
         //ΪÿŽͼ񴴽֡
@@ -105,5 +110,151 @@ namespace easyVulkan {
     }
 
     
-}
+    // Ƶͼ񣬰豸ֵ֧ĳ̶ѡã
+    // 1.̬ȾVulkan1.3ûȾͨ֡壬ؽʱؽκζ
+    // 2.ͼ֡壨imageless framebufferVulkan1.2Ⱦͨ䣬ֻ谴³ߴؽһ֡
+    // 3.CreateRpwf_Screen()ΪÿŽͼؽ֡
+    class screenRenderer {
+    public:
+        enum mode_t { dynamicRendering, imagelessFramebuffer, framebuffers };
+    private:
+        mode_t mode;
+        renderPass screenRenderPass;
+        framebuffer imagelessFramebuffer_screen;
 
+        void CreateImagelessFramebuffer() {
+            VkFormat format = graphicsBase::Base().SwapchainCreateInfo().imageFormat;
+            VkFramebufferAttachmentImageInfo attachmentImageInfo = {
+                .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENT_IMAGE_INFO,
+                .usage = graphicsBase::Base().SwapchainCreateInfo().imageUsage,
+                .width = windowSize.width,
+                .height = windowSize.height,
+                .layerCount = 1,
+                .viewFormatCount = 1,
+                .pViewFormats = &format
+            };
+            VkFramebufferAttachmentsCreateInfo attachmentsCreateInfo = {
+                .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_ATTACHMENTS_CREATE_INFO,
+                .attachmentImageInfoCount = 1,
+                .pAttachmentImageInfos = &attachmentImageInfo
+            };
+            VkFramebufferCreateInfo framebufferCreateInfo = {
+                .pNext = &attachmentsCreateInfo,
+                .flags = VK_FRAMEBUFFER_CREATE_IMAGELESS_BIT,
+                .renderPass = screenRenderPass,
+                .attachmentCount = 1,
+                .width = windowSize.width,
+                .height = windowSize.height,
+                .layers = 1
+            };
+            imagelessFramebuffer_screen.Create(framebufferCreateInfo);
+        }
+    public:
+        screenRenderer() {
+            if (graphicsBase::Base().DeviceApiVersion() >= VK_API_VERSION_1_3 &&
+                graphicsBase::Base().PhysicalDeviceVulkan13Features().dynamicRendering)
+                mode = dynamicRendering;
+            else if (graphicsBase::Base().DeviceApiVersion() >= VK_API_VERSION_1_2 &&
+                graphicsBase::Base().PhysicalDeviceVulkan12Features().imagelessFramebuffer) {
+                mode = imagelessFramebuffer;
+                CreateRenderPass_Screen(screenRenderPass);
+                CreateImagelessFramebuffer();
+                graphicsBase::Base().AddCallback_CreateSwapchain([this] { CreateImagelessFramebuffer(); });
+                graphicsBase::Base().AddCallback_DestroySwapchain([this] { imagelessFramebuffer_screen.~framebuffer(); });
+            }
+            else
+                mode = framebuffers,
+                CreateRpwf_Screen();
+        }
+        screenRenderer(screenRenderer&&) = delete;
+        //Getter
+        mode_t Mode() const { return mode; }
+        //Const Function
+        //ùߵȾĿ̬꣬ȾʱָʽָȾͨ
+        void SetPipelineTarget(graphicsPipelineCreateInfoPack& pack) const {
+            if (mode == dynamicRendering)
+                pack.UseDynamicRendering(graphicsBase::Base().SwapchainCreateInfo().imageFormat);
+            else
+                pack.createInfo.renderPass = mode == imagelessFramebuffer ? VkRenderPass(screenRenderPass) : VkRenderPass(CreateRpwf_Screen().renderPass);
+        }
+        //ʼȾǰĽͼ񣬶̬Ⱦʱɴ˴תͼڴ沼֣Ⱦͨɸɣ
+        void CmdBegin(VkCommandBuffer commandBuffer, const VkClearValue& clearValue) const {
+            uint32_t i = graphicsBase::Base().CurrentImageIndex();
+            VkRect2D renderArea = { {}, windowSize };
+            switch (mode) {
+            case dynamicRendering: {
+                VkImageMemoryBarrier imageMemoryBarrier = {
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                    .srcAccessMask = 0,
+                    .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = graphicsBase::Base().SwapchainImage(i),
+                    .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+                };
+                //ȴsemaphore_imageIsAvailableĽ׶һ£ͬCreateRenderPass_Screen(...)еͨ
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0,
+                    0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+                VkRenderingAttachmentInfo colorAttachment = commandBuffer::RenderingAttachment(
+                    graphicsBase::Base().SwapchainImageView(i), VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE, clearValue);
+                VkRenderingInfo renderingInfo = {
+                    .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                    .renderArea = renderArea,
+                    .layerCount = 1,
+                    .colorAttachmentCount = 1,
+                    .pColorAttachments = &colorAttachment
+                };
+                vkCmdBeginRendering(commandBuffer, &renderingInfo);
+            } break;
+            case imagelessFramebuffer: {
+                VkImageView attachment = graphicsBase::Base().SwapchainImageView(i);
+                VkRenderPassAttachmentBeginInfo attachmentBeginInfo = {
+                    .sType = VK_STRUCTURE_TYPE_RENDER_PASS_ATTACHMENT_BEGIN_INFO,
+                    .attachmentCount = 1,
+                    .pAttachments = &attachment
+                };
+                VkRenderPassBeginInfo beginInfo = {
+                    .pNext = &attachmentBeginInfo,
+                    .framebuffer = imagelessFramebuffer_screen,
+                    .renderArea = renderArea,
+                    .clearValueCount = 1,
+                    .pClearValues = &clearValue
+                };
+                screenRenderPass.CmdBegin(commandBuffer, beginInfo);
+            } break;
+            case framebuffers: {
+                auto& rpwf = CreateRpwf_Screen();
+                rpwf.renderPass.CmdBegin(commandBuffer, rpwf.framebuffers[i], renderArea, clearValue);
+            } break;
+            }
+        }
+        void CmdEnd(VkCommandBuffer commandBuffer) const {
+            if (mode != dynamicRendering) {
+                vkCmdEndRenderPass(commandBuffer);
+                return;
+            }
+            vkCmdEndRendering(commandBuffer);
+            VkImageMemoryBarrier imageMemoryBarrier = {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                .dstAccessMask = 0,
+                .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = graphicsBase::Base().SwapchainImage(graphicsBase::Base().CurrentImageIndex()),
+                .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+            };
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                0, nullptr, 0, nullptr, 1, &imageMemoryBarrier);
+        }
+    };
+
+    //ڴ߼豸
+    inline const screenRenderer& ScreenRenderer() {
+        static screenRenderer renderer;
+        return renderer;
+    }
+}
\ No newline at end of file
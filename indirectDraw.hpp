@@ -0,0 +1,221 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "computeDispatch.hpp"
+#include "oneShotExecutor.hpp"
+
+// GPU-driven Indirect Drawing
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 各物体的变换和包围球存放在设备内存中，绘制前由计算着色器（shaders/cull.cs.hlsl）做视锥剔除，将通过的物体压缩写入间接绘制命令的缓冲区
+    // 之后以一次vkCmdDrawIndexedIndirectCount(...)绘制，CPU每帧只录制固定的几条命令，开销与物体数无关
+    // 不支持drawIndirectCount时不压缩，被剔除的物体的instanceCount为0，以多重间接绘制（multiDrawIndirect）绘制全部物体
+    // 间接命令的firstInstance为物体索引，顶点着色器据此从ObjectBuffer()中读取物体数据（该缓冲区须由调用者绑定到图形管线的描述符集），因而需drawIndirectFirstInstance特性
+    class indirectDrawList {
+    public:
+        //与着色器中的ObjectData一致（std430）
+        struct objectData {
+            glm::mat4 transform;
+            glm::vec4 boundingSphere; //xyz为模型空间中的球心，w为半径
+            uint32_t indexCount;
+            uint32_t firstIndex;
+            int32_t vertexOffset;
+            uint32_t padding = 0;
+        };
+        static_assert(sizeof(objectData) == 96);
+    private:
+        struct cullConstants {
+            glm::vec4 frustumPlanes[6];
+            uint32_t objectCount;
+        };
+        struct specializationConstants {
+            VkBool32 compact;
+        };
+        bufferMemory objects;
+        bufferMemory drawCommands;
+        bufferMemory drawCount;
+        descriptorSetLayout setLayout;
+        pipelineLayout layout;
+        descriptorPool pool;
+        descriptorSet set;
+        computeKernel cullKernel;
+        uint32_t capacity = 0;
+        uint32_t objectCount = 0;
+        bool useDrawIndirectCount = false;
+        bool useMultiDraw = false;
+
+        static result_t CreateBuffer(bufferMemory& bufferMemory, VkDeviceSize size, VkBufferUsageFlags usage) {
+            VkBufferCreateInfo createInfo = {
+                .size = size,
+                .usage = usage
+            };
+            return bufferMemory.Create(createInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+    public:
+        indirectDrawList() = default;
+        indirectDrawList(uint32_t capacity, const char* cullShaderPath = "shaders/cull.cs.spv") {
+            Create(capacity, cullShaderPath);
+        }
+        indirectDrawList(indirectDrawList&&) = delete;
+        //Getter
+        VkBuffer ObjectBuffer() const { return objects.Buffer(); }
+        VkBuffer DrawCommandBuffer() const { return drawCommands.Buffer(); }
+        VkBuffer DrawCountBuffer() const { return drawCount.Buffer(); }
+        uint32_t Capacity() const { return capacity; }
+        uint32_t ObjectCount() const { return objectCount; }
+        bool UsesDrawIndirectCount() const { return useDrawIndirectCount; }
+        //Const Function
+        //录制剔除，须在渲染通道外录制，且在同一队列上位于CmdDraw(...)之前
+        void CmdCull(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection) const {
+            if (!objectCount)
+                return;
+            cullConstants constants = { .objectCount = objectCount };
+            FrustumPlanes(viewProjection, constants.frustumPlanes);
+            //先前的间接绘制读取完毕后才能覆写，同时使Upload(...)中复制的物体数据对计算着色器可见
+            VkMemoryBarrier memoryBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_READ_BIT
+            };
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                1, &memoryBarrier, 0, nullptr, 0, nullptr);
+            if (useDrawIndirectCount) {
+                vkCmdFillBuffer(commandBuffer, drawCount.Buffer(), 0, sizeof(uint32_t), 0);
+                memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                    1, &memoryBarrier, 0, nullptr, 0, nullptr);
+            }
+            vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullKernel.Pipeline());
+            vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, set.Address(), 0, nullptr);
+            vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof constants, &constants);
+            vkCmdDispatch(commandBuffer, cullKernel.GroupCount(objectCount)[0], 1, 1);
+            memoryBarrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT
+            };
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+                1, &memoryBarrier, 0, nullptr, 0, nullptr);
+        }
+        //录制绘制，调用前需绑定图形管线、描述符集、顶点和索引缓冲区
+        void CmdDraw(VkCommandBuffer commandBuffer) const {
+            if (!objectCount)
+                return;
+            constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+            uint32_t maxDrawCount = graphicsBase::Base().PhysicalDeviceProperties().limits.maxDrawIndirectCount;
+            if (useDrawIndirectCount)
+                vkCmdDrawIndexedIndirectCount(commandBuffer, drawCommands.Buffer(), 0, drawCount.Buffer(), 0, std::min(objectCount, maxDrawCount), stride);
+            else if (useMultiDraw)
+                for (uint32_t i = 0; i < objectCount; i += maxDrawCount)
+                    vkCmdDrawIndexedIndirect(commandBuffer, drawCommands.Buffer(), VkDeviceSize(i) * stride, std::min(objectCount - i, maxDrawCount), stride);
+            //既不支持drawIndirectCount也不支持multiDrawIndirect的设备极少，此时退化为逐个间接绘制
+            else
+                for (uint32_t i = 0; i < objectCount; i++)
+                    vkCmdDrawIndexedIndirect(commandBuffer, drawCommands.Buffer(), VkDeviceSize(i) * stride, 1, stride);
+        }
+        //Non-const Function
+        //以暂存缓冲区上传物体数据，从firstObject开始覆写，物体数随之增长，阻塞到复制完毕
+        //executor须提交到图形队列，复制前等待先前提交的命令中对物体数据的读取，CmdCull(...)中的屏障则使复制的结果可见
+        result_t Upload(oneShotExecutor& executor, arrayRef<const objectData> data, uint32_t firstObject = 0) {
+            if (firstObject + data.Count() > capacity) {
+                outStream << std::format("[ indirectDrawList ] ERROR\nObject count exceeds the capacity {}!\n", capacity);
+                return VK_RESULT_MAX_ENUM;
+            }
+            if (!data.Count())
+                return VK_SUCCESS;
+            VkDeviceSize size = data.Count() * sizeof(objectData);
+            VkBufferCreateInfo createInfo = {
+                .size = size,
+                .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+            };
+            bufferMemory stagingBuffer;
+            if (VkResult result = stagingBuffer.Create(createInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+                return result;
+            if (VkResult result = stagingBuffer.BufferData(data.Pointer(), size))
+                return result;
+            if (VkResult result = executor.Execute([&](VkCommandBuffer commandBuffer) {
+                //先前提交的剔除和绘制可能仍在读取将被覆写的物体数据，只需执行依赖
+                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                    0, nullptr, 0, nullptr, 0, nullptr);
+                VkBufferCopy region = { 0, firstObject * sizeof(objectData), size };
+                vkCmdCopyBuffer(commandBuffer, stagingBuffer.Buffer(), objects.Buffer(), 1, &region);
+            }))
+                return result;
+            objectCount = std::max(objectCount, firstObject + uint32_t(data.Count()));
+            return VK_SUCCESS;
+        }
+        //截断物体数，之后的物体不再参与剔除和绘制
+        void ObjectCount(uint32_t count) { objectCount = std::min(count, capacity); }
+        result_t Create(uint32_t capacity, const char* cullShaderPath = "shaders/cull.cs.spv") {
+            auto& base = graphicsBase::Base();
+            if (!base.PhysicalDeviceFeatures().drawIndirectFirstInstance) {
+                outStream << std::format("[ indirectDrawList ] ERROR\nThe drawIndirectFirstInstance feature is required to pass object indices through firstInstance!\n");
+                return VK_ERROR_FEATURE_NOT_PRESENT;
+            }
+            useMultiDraw = base.PhysicalDeviceFeatures().multiDrawIndirect;
+            useDrawIndirectCount = useMultiDraw &&
+                base.DeviceApiVersion() >= VK_API_VERSION_1_2 &&
+                base.PhysicalDeviceVulkan12Features().drawIndirectCount;
+            this->capacity = capacity;
+            objectCount = 0;
+            if (VkResult result = CreateBuffer(objects, capacity * sizeof(objectData),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+                return result;
+            if (VkResult result = CreateBuffer(drawCommands, capacity * sizeof(VkDrawIndexedIndirectCommand),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT))
+                return result;
+            if (VkResult result = CreateBuffer(drawCount, sizeof(uint32_t),
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+                return result;
+            //Descriptor
+            VkDescriptorSetLayoutBinding bindings[3] = {};
+            for (uint32_t i = 0; i < 3; i++)
+                bindings[i] = { i, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT };
+            VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo = {
+                .bindingCount = 3,
+                .pBindings = bindings
+            };
+            if (VkResult result = setLayout.Create(setLayoutCreateInfo))
+                return result;
+            VkPushConstantRange pushConstantRange = { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(cullConstants) };
+            VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo = {
+                .setLayoutCount = 1,
+                .pSetLayouts = setLayout.Address(),
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &pushConstantRange
+            };
+            if (VkResult result = layout.Create(pipelineLayoutCreateInfo))
+                return result;
+            VkDescriptorPoolSize poolSize = { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 };
+            if (VkResult result = pool.Create(1, poolSize))
+                return result;
+            if (VkResult result = pool.AllocateSets(set, setLayout))
+                return result;
+            VkDescriptorBufferInfo bufferInfos[3] = {
+                { objects.Buffer(), 0, VK_WHOLE_SIZE },
+                { drawCommands.Buffer(), 0, VK_WHOLE_SIZE },
+                { drawCount.Buffer(), 0, VK_WHOLE_SIZE }
+            };
+            set.Write(bufferInfos, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+            //Pipeline
+            specializationInfo<specializationConstants> specialization({ useDrawIndirectCount });
+            return cullKernel.Create(cullShaderPath, layout, "main", specialization);
+        }
+        //Static Function
+        //从观察投影矩阵提取视锥的六个平面（法线朝内，已归一化），深度范围为[0, 1]
+        static void FrustumPlanes(const glm::mat4& viewProjection, glm::vec4(&planes)[6]) {
+            glm::mat4 rows = glm::transpose(viewProjection);
+            planes[0] = rows[3] + rows[0]; //Left
+            planes[1] = rows[3] - rows[0]; //Right
+            planes[2] = rows[3] + rows[1]; //Bottom
+            planes[3] = rows[3] - rows[1]; //Top
+            planes[4] = rows[2];           //Near
+            planes[5] = rows[3] - rows[2]; //Far
+            for (auto& i : planes)
+                i /= glm::length(glm::vec3(i));
+        }
+    };
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "commandEncoder.hpp"
+
+// Instance Batcher
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 默认的逐实例数据，自定义的实例结构体须同样提供Members()，列出作为顶点属性的成员
+    // 成员可为float、int32_t、uint32_t、glm的2~4维向量或矩阵（矩阵的每一列占一个location）
+    struct instanceData {
+        glm::mat4 transform;
+        glm::vec4 color;
+        uint32_t id;
+        static constexpr auto Members() {
+            return std::make_tuple(&instanceData::transform, &instanceData::color, &instanceData::id);
+        }
+    };
+
+    // 收集同一网格的各个实例，每帧将逐实例数据写入该帧的缓冲区，每种网格只需一次vkCmdDraw(Indexed)(...)
+    // 缓冲区持久映射，每个飞行中的帧一个，容量不足时加倍重建
+    template<typename T = instanceData>
+    class instanceBatcher {
+    public:
+        struct mesh {
+            VkBuffer vertexBuffer = VK_NULL_HANDLE;
+            VkDeviceSize vertexBufferOffset = 0;
+            VkBuffer indexBuffer = VK_NULL_HANDLE;     //为VK_NULL_HANDLE时以vkCmdDraw(...)绘制
+            VkDeviceSize indexBufferOffset = 0;
+            VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+            uint32_t count = 0;                        //索引数或顶点数
+            uint32_t first = 0;                        //首个索引或顶点
+            int32_t vertexOffset = 0;
+        };
+    private:
+        struct frameSlot {
+            bufferMemory instanceBuffer;
+            void* pMapped = nullptr;
+            uint32_t capacity = 0;
+        };
+        struct batch {
+            uint32_t meshId;
+            uint32_t firstInstance;
+            uint32_t instanceCount;
+        };
+        std::vector<mesh> meshes;
+        std::vector<std::vector<T>> instances; //[网格][实例]
+        std::vector<batch> batches;
+        std::vector<frameSlot> frames;
+        uint32_t currentFrame = 0;
+        uint32_t vertexBinding = 0;
+        uint32_t instanceBinding = 1;
+        bool hasVertexBinding = true; //为false时管线只有逐实例的绑定，不绑定网格的顶点缓冲区
+
+        template<typename M>
+        static constexpr VkFormat Format() {
+            if constexpr (std::same_as<M, float>) return VK_FORMAT_R32_SFLOAT;
+            else if constexpr (std::same_as<M, glm::vec2>) return VK_FORMAT_R32G32_SFLOAT;
+            else if constexpr (std::same_as<M, glm::vec3>) return VK_FORMAT_R32G32B32_SFLOAT;
+            else if constexpr (std::same_as<M, glm::vec4>) return VK_FORMAT_R32G32B32A32_SFLOAT;
+            else if constexpr (std::same_as<M, int32_t>) return VK_FORMAT_R32_SINT;
+            else if constexpr (std::same_as<M, glm::ivec2>) return VK_FORMAT_R32G32_SINT;
+            else if constexpr (std::same_as<M, glm::ivec3>) return VK_FORMAT_R32G32B32_SINT;
+            else if constexpr (std::same_as<M, glm::ivec4>) return VK_FORMAT_R32G32B32A32_SINT;
+            else if constexpr (std::same_as<M, uint32_t>) return VK_FORMAT_R32_UINT;
+            else if constexpr (std::same_as<M, glm::uvec2>) return VK_FORMAT_R32G32_UINT;
+            else if constexpr (std::same_as<M, glm::uvec3>) return VK_FORMAT_R32G32B32_UINT;
+            else if constexpr (std::same_as<M, glm::uvec4>) return VK_FORMAT_R32G32B32A32_UINT;
+            else static_assert(sizeof(M) == 0, "Unsupported instance attribute type.");
+        }
+        template<typename attributes_t, typename M>
+        static void AppendAttribute(attributes_t& attributes, uint32_t binding, uint32_t& location, M T::* member) {
+            static const T object = {};
+            uint32_t offset = uint32_t(reinterpret_cast<const uint8_t*>(&(object.*member)) - reinterpret_cast<const uint8_t*>(&object));
+            if constexpr (requires { typename M::col_type; })
+                for (uint32_t i = 0; i < uint32_t(M::length()); i++)
+                    attributes.push_back({ location++, binding, Format<typename M::col_type>(), uint32_t(offset + i * sizeof(typename M::col_type)) });
+            else
+                attributes.push_back({ location++, binding, Format<M>(), offset });
+        }
+        result_t Reserve(frameSlot& frame, uint32_t instanceCount) {
+            if (instanceCount <= frame.capacity)
+                return VK_SUCCESS;
+            uint32_t capacity = std::max(instanceCount, frame.capacity * 2);
+            VkBufferCreateInfo createInfo = {
+                .size = capacity * sizeof(T),
+                .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+            };
+            bufferMemory newBuffer;
+            if (VkResult result = newBuffer.Create(createInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+                return result;
+            void* pMapped;
+            if (VkResult result = newBuffer.MapMemory(pMapped, VK_WHOLE_SIZE))
+                return result;
+            frame.instanceBuffer = std::move(newBuffer);
+            frame.pMapped = pMapped;
+            frame.capacity = capacity;
+            return VK_SUCCESS;
+        }
+    public:
+        instanceBatcher(uint32_t framesInFlight = 2) :frames(framesInFlight) {}
+        instanceBatcher(instanceBatcher&&) = default;
+        //Getter
+        uint32_t InstanceBinding() const { return instanceBinding; }
+        //上次Flush()得到的批次数，即绘制调用数
+        uint32_t BatchCount() const { return uint32_t(batches.size()); }
+        //Const Function
+        //依次录制各批次，调用前需绑定管线和描述符集
+        void Record(commandEncoder& encoder) const {
+            if (batches.empty())
+                return;
+            VkBuffer instanceBuffer = frames[currentFrame].instanceBuffer.Buffer();
+            VkDeviceSize offset = 0;
+            encoder.BindVertexBuffers(instanceBinding, instanceBuffer, offset);
+            for (auto& [meshId, firstInstance, instanceCount] : batches) {
+                auto& batchMesh = meshes[meshId];
+                if (hasVertexBinding && batchMesh.vertexBuffer)
+                    encoder.BindVertexBuffers(vertexBinding, batchMesh.vertexBuffer, batchMesh.vertexBufferOffset);
+                if (batchMesh.indexBuffer)
+                    encoder.BindIndexBuffer(batchMesh.indexBuffer, batchMesh.indexBufferOffset, batchMesh.indexType),
+                    vkCmdDrawIndexed(encoder, batchMesh.count, instanceCount, batchMesh.first, batchMesh.vertexOffset, firstInstance);
+                else
+                    vkCmdDraw(encoder, batchMesh.count, instanceCount, batchMesh.first, firstInstance);
+            }
+        }
+        //Non-const Function
+        //将逐实例的顶点绑定及属性添加到pack，绑定号和location接在pack中已有的之后
+        //网格的顶点缓冲区绑定到pack中编号最小的绑定，应在添加逐顶点的绑定和属性后调用，pack中没有绑定时（顶点由着色器生成）网格的顶点缓冲区被忽略
+        //pack可为graphicsPipelineCreateInfoPack或fixedGraphicsPipelineCreateInfoPack
+        template<typename pack_t>
+        void SetupPipeline(pack_t& pack) {
+            hasVertexBinding = pack.vertexInputBindings.size();
+            vertexBinding = hasVertexBinding ? UINT32_MAX : 0;
+            instanceBinding = 0;
+            for (auto& i : pack.vertexInputBindings)
+                vertexBinding = std::min(vertexBinding, i.binding),
+                instanceBinding = std::max(instanceBinding, i.binding + 1);
+            uint32_t location = 0;
+            for (auto& i : pack.vertexInputAttributes)
+                location = std::max(location, i.location + 1);
+            pack.vertexInputBindings.push_back({ instanceBinding, uint32_t(sizeof(T)), VK_VERTEX_INPUT_RATE_INSTANCE });
+            std::apply([&](auto... members) {
+                (AppendAttribute(pack.vertexInputAttributes, instanceBinding, location, members), ...);
+            }, T::Members());
+        }
+        //登记网格，返回用于Add(...)的网格ID
+        uint32_t RegisterMesh(const mesh& newMesh) {
+            meshes.push_back(newMesh);
+            instances.emplace_back();
+            return uint32_t(meshes.size() - 1);
+        }
+        //在每帧开始时调用，清空上一帧收集的实例，调用前需确保framesInFlight帧前的绘制已执行完毕
+        void BeginFrame() {
+            currentFrame = (currentFrame + 1) % frames.size();
+            for (auto& i : instances)
+                i.clear();
+            batches.clear();
+        }
+        void Add(uint32_t meshId, const T& instance) {
+            instances[meshId].push_back(instance);
+        }
+        //将收集的实例按网格连续写入当帧的缓冲区，在Record(...)前调用
+        result_t Flush() {
+            uint32_t instanceCount = 0;
+            for (auto& i : instances)
+                instanceCount += uint32_t(i.size());
+            auto& frame = frames[currentFrame];
+            if (VkResult result = Reserve(frame, instanceCount))
+                return result;
+            batches.clear();
+            uint32_t firstInstance = 0;
+            for (uint32_t i = 0; i < instances.size(); i++) {
+                if (instances[i].empty())
+                    continue;
+                memcpy(static_cast<T*>(frame.pMapped) + firstInstance, instances[i].data(), instances[i].size() * sizeof(T));
+                batches.push_back({ i, firstInstance, uint32_t(instances[i].size()) });
+                firstInstance += uint32_t(instances[i].size());
+            }
+            return VK_SUCCESS;
+        }
+    };
+}
@@ -1,50 +1,48 @@
 #include "GlfwGeneral.hpp"
 #include "easyVk.hpp"
+#include "shaderHotReload.hpp"
+#include "spirvReflection.hpp"
+#include "commandAllocator.hpp"
 
 using namespace vulkan;
 
-pipelineLayout pipelineLayout_triangle; //߲
+VkPipelineLayout pipelineLayout_triangle; //߲֣layouts
 pipeline pipeline_triangle;             //
-
-//úeasyVulkan::CreateRpwf_Screen()洢صõ̬
-const auto& RenderPassAndFramebuffers() {
-    static const auto& rpwf = easyVulkan::CreateRpwf_Screen(); // staticֻڵһεñֵ
-    return rpwf;
-}
+easyVulkan::shaderHotReloader shaderReloader; //ɫ
+easyVulkan::layoutCache layouts;              //פֺ͹߲
 
 void CreateLayout() {
-    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
-    pipelineLayout_triangle.Create(pipelineLayoutCreateInfo);
+    //ɫõ߲֣ɫõԴıʱֶͬ
+    easyVulkan::shaderReflection reflection("shaders/triangle.vs.spv");
+    reflection.Merge(easyVulkan::shaderReflection("shaders/triangle.ps.spv"));
+    pipelineLayout_triangle = layouts.PipelineLayout(reflection);
 }
 
 void CreatePipeline() {
-    static shaderModule vs("shaders/triangle.vs.spv");
-    static shaderModule ps("shaders/triangle.ps.spv");
-    static VkPipelineShaderStageCreateInfo shaderStageCreateInfos_triangle[2] = {
-        vs.StageCreateInfo(VK_SHADER_STAGE_VERTEX_BIT),
-        ps.StageCreateInfo(VK_SHADER_STAGE_FRAGMENT_BIT)
-    };
-    auto Create = [] {
-        graphicsPipelineCreateInfoPack pipelineCiPack;
-        pipelineCiPack.createInfo.layout = pipelineLayout_triangle;
-        pipelineCiPack.createInfo.renderPass = RenderPassAndFramebuffers().renderPass;
-        pipelineCiPack.inputAssemblyStateCi.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-        pipelineCiPack.viewports.emplace_back(0.f, 0.f, float(windowSize.width), float(windowSize.height), 0.f, 1.f);
-        pipelineCiPack.scissors.emplace_back(VkOffset2D{}, windowSize);
-        pipelineCiPack.multisampleStateCi.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-        pipelineCiPack.colorBlendAttachmentStates.push_back({ .colorWriteMask = 0b1111 });
-        pipelineCiPack.UpdateAllArrays();
-        pipelineCiPack.createInfo.stageCount = 2;
-        pipelineCiPack.createInfo.pStages = shaderStageCreateInfos_triangle;
-        pipeline_triangle.Create(pipelineCiPack);
-        };
-    auto Destroy = [] {
-        pipeline_triangle.~pipeline();
-        };
-    graphicsBase::Base().AddCallback_CreateSwapchain(Create);
-    graphicsBase::Base().AddCallback_DestroySwapchain(Destroy);
-    //Create()Դ
-    Create();
+    //ɫshaderReloaderɫļĶ߻ں̨ؽ
+    shaderReloader.AddPipeline(pipeline_triangle,
+        { { "shaders/triangle.vs.spv", VK_SHADER_STAGE_VERTEX_BIT },
+          { "shaders/triangle.ps.spv", VK_SHADER_STAGE_FRAGMENT_BIT } },
+        [](pipeline& pipeline, std::span<const VkPipelineShaderStageCreateInfo> shaderStages) -> result_t {
+            graphicsPipelineCreateInfoPack pipelineCiPack;
+            pipelineCiPack.createInfo.layout = pipelineLayout_triangle;
+            easyVulkan::ScreenRenderer().SetPipelineTarget(pipelineCiPack);
+            pipelineCiPack.inputAssemblyStateCi.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+            //ӿںͼ÷ΧΪ̬״̬ڳߴıʱؽ
+            pipelineCiPack.dynamicStates.push_back(VK_DYNAMIC_STATE_VIEWPORT);
+            pipelineCiPack.dynamicStates.push_back(VK_DYNAMIC_STATE_SCISSOR);
+            pipelineCiPack.multisampleStateCi.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+            pipelineCiPack.colorBlendAttachmentStates.push_back({ .colorWriteMask = 0b1111 });
+            pipelineCiPack.shaderStages.assign(shaderStages.begin(), shaderStages.end());
+            pipelineCiPack.UpdateAllArrays();
+            return pipeline.Create(pipelineCiPack);
+        });
+    //߲ͼĳߴ磬ؽʱؽ
+    shaderReloader.CreatePipeline(pipeline_triangle);
+#ifndef NDEBUG
+    //ʱɫĿ¼Ķ.hlsldxc±
+    shaderReloader.Watch("shaders", "dxc -spirv -T {2} -E {3} {0} -Fo {1}");
+#endif
 }
 
 
@@ -52,22 +50,23 @@ int main() {
     if (!InitializeWindow({ 1280, 720 }))
         return -1;
 
-    const auto& [renderPass, framebuffers] = RenderPassAndFramebuffers();
+    const auto& screenRenderer = easyVulkan::ScreenRenderer();
     CreateLayout();
     CreatePipeline();
 
-    fence fence(VK_FENCE_CREATE_SIGNALED_BIT); //λ״̬դ
-    semaphore semaphore_imageIsAvailable;
-    semaphore semaphore_renderingIsOver;
-
-    commandBuffer commandBuffer;
-    commandPool commandPool(graphicsBase::Base().QueueFamilyIndex_Graphics(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
-    commandPool.AllocateBuffers(commandBuffer);
+    //ÿ֡һغդcommandAllocatorУȡͼõźͬÿ֡һ
+    constexpr uint32_t framesInFlight = 2;
+    easyVulkan::frameCommandAllocator commandAllocator(graphicsBase::Base().QueueFamilyIndex_Graphics(), framesInFlight);
+    semaphore semaphores_imageIsAvailable[framesInFlight];
+    //ʱźֻܴͼٴȡõ֪ȾɵźÿŽͼһ
+    std::vector<semaphore> semaphores_renderingIsOver(graphicsBase::Base().SwapchainImageCount());
+    graphicsBase::Base().AddCallback_CreateSwapchain([&] {
+        semaphores_renderingIsOver.resize(graphicsBase::Base().SwapchainImageCount());
+    });
 
     VkClearValue clearColor = { .color = { .5f, 0.5f, 0.5f, 1.f } }; //ClearValue
 
-    //fenceȾɺλ
-    //ȾѭĿͷȴդλλ״̬fenceΪ״ִȾѭʱɵȴ
+    //֡դȾɺλcommandAllocator.BeginFrame()ȴø֡ء
     //semaphore_imageIsAvailableȡýͼλִǰȴ
     //semaphore_renderingIsOverȾɺλڳͼǰȴ
     while (!glfwWindowShouldClose(pWindow)) {
@@ -77,31 +76,43 @@ int main() {
         //----------------------------------------
 
 
+        pipelineFeedback::Registry().NextFrame();
+
+        //ȴframesInFlight֡ǰȾɣø֡
+        commandAllocator.BeginFrame();
+        //߽֡绻غؽõĹ
+        shaderReloader.ApplyPendingUpdates();
+        auto& semaphore_imageIsAvailable = semaphores_imageIsAvailable[commandAllocator.CurrentFrame()];
+
         //ȡͼ
         graphicsBase::Base().SwapImage(semaphore_imageIsAvailable);
+        auto& semaphore_renderingIsOver = semaphores_renderingIsOver[graphicsBase::Base().CurrentImageIndex()];
 
-        //ΪframebufferȡĽͼһһӦȡͼ
-        /**/ auto i = graphicsBase::Base().CurrentImageIndex();
-        
         //ʼ¼
+        auto& commandBuffer = commandAllocator.Allocate();
         commandBuffer.Begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-        /*ʼȾͨ*/ renderPass.CmdBegin(commandBuffer, framebuffers[i], { {}, windowSize }, clearColor);
+        /*ʼȾ*/ screenRenderer.CmdBegin(commandBuffer, clearColor);
         /*Ⱦ*/vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_triangle);
+        VkViewport viewport = { 0.f, 0.f, float(windowSize.width), float(windowSize.height), 0.f, 1.f };
+        VkRect2D scissor = { {}, windowSize };
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
         /*Ⱦ*/vkCmdDraw(commandBuffer, 3, 1, 0, 0);
-        /*Ⱦͨ*/ renderPass.CmdEnd(commandBuffer);
+        /*Ⱦ*/ screenRenderer.CmdEnd(commandBuffer);
         commandBuffer.End();
 
         /*ύ*/
-        graphicsBase::Base().SubmitCommandBuffer_Graphics(commandBuffer, semaphore_imageIsAvailable, semaphore_renderingIsOver, fence);
+        graphicsBase::Base().SubmitCommandBuffer_Graphics(commandBuffer, semaphore_imageIsAvailable, semaphore_renderingIsOver, commandAllocator.Fence());
         /*ͼ񣬴*/
         graphicsBase::Base().PresentImage(semaphore_renderingIsOver);
 
         glfwPollEvents();
         TitleFps();
-
-        //ȴfenceΪ˵һ֡ܽ
-        fence.WaitAndReset();
     }
+#ifndef NDEBUG
+    //ߴʱı
+    outStream << pipelineFeedback::Registry().Report();
+#endif
     TerminateWindow();
     return 0;
 }
\ No newline at end of file
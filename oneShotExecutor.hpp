@@ -0,0 +1,189 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// One-shot Command Executor
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 用于“录制几条命令，提交，等待完成”的场合，比如上传缓冲区、转换图像内存布局、生成mipmap
+    // 任意线程均可提交作业，作业由一个专门的线程录制和提交，命令缓冲区和栅栏在完成后回收复用，不逐次创建销毁
+    // 相隔很近地提交的多个作业被录制进同一个命令缓冲区，以一次vkQueueSubmit(...)提交，作业间不会自动插入屏障
+    class oneShotExecutor {
+    public:
+        //录制一个作业，在执行器的线程上调用，不得在其中同步地等待本执行器上的作业
+        using record_t = std::function<void(VkCommandBuffer)>;
+    private:
+        struct job {
+            record_t record;
+            std::promise<VkResult> done;
+        };
+        struct batch {
+            VkCommandBuffer commandBuffer;
+            fence* pFence;
+            std::vector<std::promise<VkResult>> promises;
+        };
+        //以下成员仅在执行器的线程上访问
+        commandPool pool;
+        std::vector<VkCommandBuffer> freeBuffers;
+        std::deque<fence> fences; //用deque，追加元素时已取得的指针不失效
+        std::vector<fence*> freeFences;
+        std::deque<batch> inFlight;
+        //以下成员由互斥量保护
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::vector<job> jobs;
+        bool flushRequested = false;
+        bool stopping = false;
+        bool useComputeQueue;
+        std::chrono::microseconds batchWindow;
+        uint32_t maxBatchesInFlight;
+        std::atomic<uint64_t> jobCount = 0;
+        std::atomic<uint64_t> batchCount = 0;
+        std::thread worker; //最后初始化，启动线程时其他成员均已就绪
+
+        VkCommandBuffer AcquireBuffer() {
+            if (freeBuffers.empty()) {
+                VkCommandBuffer buffer = VK_NULL_HANDLE;
+                if (pool.AllocateBuffers(buffer))
+                    return VK_NULL_HANDLE;
+                return buffer;
+            }
+            VkCommandBuffer buffer = freeBuffers.back();
+            freeBuffers.pop_back();
+            return buffer;
+        }
+        fence& AcquireFence() {
+            if (freeFences.empty())
+                return fences.emplace_back();
+            fence& acquired = *freeFences.back();
+            freeFences.pop_back();
+            return acquired;
+        }
+        static void Complete(std::vector<std::promise<VkResult>>& promises, VkResult result) {
+            for (auto& i : promises)
+                i.set_value(result);
+        }
+        void SubmitBatch(std::vector<job>& batchJobs) {
+            std::vector<std::promise<VkResult>> promises;
+            promises.reserve(batchJobs.size());
+            for (auto& i : batchJobs)
+                promises.push_back(std::move(i.done));
+            VkCommandBuffer buffer = AcquireBuffer();
+            if (!buffer)
+                return Complete(promises, VK_RESULT_MAX_ENUM);
+            VkCommandBufferBeginInfo beginInfo = {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+            };
+            VkResult result = vkBeginCommandBuffer(buffer, &beginInfo);
+            if (!result) {
+                for (auto& i : batchJobs)
+                    i.record(buffer);
+                result = vkEndCommandBuffer(buffer);
+            }
+            if (result) {
+                outStream << std::format("[ oneShotExecutor ] ERROR\nFailed to record a batch!\nError code: {}\n", int32_t(result));
+                freeBuffers.push_back(buffer);
+                return Complete(promises, result);
+            }
+            fence& batchFence = AcquireFence();
+            VkSubmitInfo submitInfo = {
+                .commandBufferCount = 1,
+                .pCommandBuffers = &buffer
+            };
+            if ((result = useComputeQueue ?
+                graphicsBase::Base().SubmitCommandBuffer_Compute(submitInfo, batchFence) :
+                graphicsBase::Base().SubmitCommandBuffer_Graphics(submitInfo, batchFence))) {
+                freeBuffers.push_back(buffer);
+                freeFences.push_back(&batchFence);
+                return Complete(promises, result);
+            }
+            batchCount.fetch_add(1, std::memory_order_relaxed);
+            inFlight.push_back({ buffer, &batchFence, std::move(promises) });
+        }
+        //等待最早提交的一批完成，命令缓冲区随下次vkBeginCommandBuffer(...)隐式重置
+        void RetireOldest() {
+            batch& oldest = inFlight.front();
+            VkResult result = oldest.pFence->WaitAndReset();
+            Complete(oldest.promises, result);
+            //栅栏等待失败时不回收，以免复用状态不明的栅栏
+            if (!result)
+                freeBuffers.push_back(oldest.commandBuffer),
+                freeFences.push_back(oldest.pFence);
+            inFlight.pop_front();
+        }
+        void Run() {
+            while (true) {
+                std::vector<job> batchJobs;
+                {
+                    std::unique_lock lock(mutex);
+                    if (inFlight.empty())
+                        condition.wait(lock, [this] { return stopping || jobs.size(); });
+                    if (inFlight.size() < maxBatchesInFlight) {
+                        //首个作业到来后再等一小段时间，使紧接着请求的作业进入同一批
+                        if (jobs.size())
+                            condition.wait_for(lock, batchWindow, [this] { return stopping || flushRequested; });
+                        batchJobs.swap(jobs);
+                        flushRequested = false;
+                    }
+                    if (stopping && batchJobs.empty() && inFlight.empty())
+                        return;
+                }
+                if (batchJobs.size())
+                    SubmitBatch(batchJobs);
+                else
+                    RetireOldest();
+            }
+        }
+    public:
+        //useComputeQueue为true时提交到计算队列，否则提交到图形队列
+        //batchWindow为首个作业到来后等待后续作业的时长，maxBatchesInFlight为同时在执行的批次上限
+        oneShotExecutor(bool useComputeQueue = false, std::chrono::microseconds batchWindow = std::chrono::microseconds(200), uint32_t maxBatchesInFlight = 2) :
+            pool(useComputeQueue ?
+                graphicsBase::Base().QueueFamilyIndex_Compute() :
+                graphicsBase::Base().QueueFamilyIndex_Graphics(),
+                VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT),
+            useComputeQueue(useComputeQueue), batchWindow(batchWindow), maxBatchesInFlight(std::max(maxBatchesInFlight, 1u)),
+            worker([this] { Run(); }) {}
+        oneShotExecutor(oneShotExecutor&&) = delete;
+        //析构时执行完所有已提交的作业
+        ~oneShotExecutor() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            condition.notify_one();
+            worker.join();
+        }
+        //Getter
+        //已提交的作业数和实际的提交次数，两者之比即平均每批的作业数
+        uint64_t JobCount() const { return jobCount.load(std::memory_order_relaxed); }
+        uint64_t BatchCount() const { return batchCount.load(std::memory_order_relaxed); }
+        //Non-const Function
+        //提交一个作业，返回的future在GPU执行完该作业所在的批次后就绪
+        std::future<VkResult> Submit(record_t record) {
+            std::future<VkResult> future;
+            {
+                std::lock_guard lock(mutex);
+                future = jobs.emplace_back(std::move(record)).done.get_future();
+            }
+            jobCount.fetch_add(1, std::memory_order_relaxed);
+            condition.notify_one();
+            return future;
+        }
+        //提交一个作业并阻塞到其执行完毕，其他线程同时提交的作业仍可与之合批
+        result_t Execute(record_t record) {
+            return Submit(std::move(record)).get();
+        }
+        //不再等待后续作业，立即提交已有的作业
+        void Flush() {
+            {
+                std::lock_guard lock(mutex);
+                flushRequested = true;
+            }
+            condition.notify_one();
+        }
+    };
+}
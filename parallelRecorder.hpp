@@ -0,0 +1,110 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "threadPool.hpp"
+
+// Parallel Command Recording
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 将一串绘制分块，在线程池中并行录制到二级命令缓冲区，再由主命令缓冲区以vkCmdExecuteCommands(...)执行
+    // 命令池不可被多个线程同时使用，这里每帧为每个分块准备一个命令池，同一时刻只有录制该分块的线程会用到它
+    // 每帧开始时整体重置当帧的命令池，二级命令缓冲区不逐个释放而是复用
+    class parallelRecorder {
+    public:
+        //录制[begin, end)范围内的绘制，在工作线程上调用
+        using recordFunction_t = std::function<void(VkCommandBuffer, uint32_t begin, uint32_t end)>;
+    private:
+        struct slot {
+            commandPool pool;
+            std::vector<VkCommandBuffer> buffers;
+            uint32_t usedCount = 0;
+        };
+        threadPool& workers;
+        std::vector<std::vector<slot>> frames; //[帧][分块]
+        uint32_t currentFrame = 0;
+        uint32_t minChunkSize;
+
+        VkCommandBuffer NextBuffer(slot& chunkSlot) {
+            if (chunkSlot.usedCount == chunkSlot.buffers.size()) {
+                VkCommandBuffer buffer = VK_NULL_HANDLE;
+                if (chunkSlot.pool.AllocateBuffers(buffer, VK_COMMAND_BUFFER_LEVEL_SECONDARY))
+                    return VK_NULL_HANDLE;
+                chunkSlot.buffers.push_back(buffer);
+            }
+            return chunkSlot.buffers[chunkSlot.usedCount++];
+        }
+    public:
+        //minChunkSize为每块至少包含的绘制数，绘制太少时分块反而得不偿失
+        parallelRecorder(threadPool& workers, uint32_t queueFamilyIndex, uint32_t framesInFlight, uint32_t minChunkSize = 256) :
+            workers(workers), frames(framesInFlight), minChunkSize(minChunkSize) {
+            uint32_t chunkCount = std::max(workers.ThreadCount(), 1u);
+            for (auto& i : frames) {
+                i.resize(chunkCount);
+                for (auto& j : i)
+                    j.pool.Create(queueFamilyIndex, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+            }
+        }
+        parallelRecorder(parallelRecorder&&) = delete;
+        //Getter
+        uint32_t ChunkCount() const { return uint32_t(frames[0].size()); }
+        //Non-const Function
+        //在每帧开始录制前调用，调用前需确保framesInFlight帧前提交的命令已执行完毕（比如已等待该帧的栅栏）
+        result_t BeginFrame() {
+            currentFrame = (currentFrame + 1) % frames.size();
+            for (auto& i : frames[currentFrame]) {
+                if (VkResult result = i.pool.Reset())
+                    return result;
+                i.usedCount = 0;
+            }
+            return VK_SUCCESS;
+        }
+        //并行录制drawCount个绘制并在primaryCommandBuffer中执行
+        //primaryCommandBuffer须已以VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS开始渲染通道，
+        //或以VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT开始动态渲染（此时inheritanceInfo.pNext须接入VkCommandBufferInheritanceRenderingInfo）
+        //同一帧内可多次调用，录制函数中需自行绑定管线、描述符集并设置动态状态，二级命令缓冲区不继承这些状态
+        result_t Record(VkCommandBuffer primaryCommandBuffer, uint32_t drawCount, const recordFunction_t& record, const VkCommandBufferInheritanceInfo& inheritanceInfo) {
+            if (!drawCount)
+                return VK_SUCCESS;
+            auto& slots = frames[currentFrame];
+            uint32_t chunkCount = std::min(uint32_t(slots.size()), (drawCount + minChunkSize - 1) / minChunkSize);
+            uint32_t chunkSize = (drawCount + chunkCount - 1) / chunkCount;
+            std::vector<VkCommandBuffer> buffers(chunkCount);
+            for (uint32_t i = 0; i < chunkCount; i++)
+                if (!(buffers[i] = NextBuffer(slots[i])))
+                    return VK_RESULT_MAX_ENUM;
+            std::vector<std::future<VkResult>> futures;
+            for (uint32_t i = 0; i < chunkCount; i++) {
+                uint32_t begin = i * chunkSize, end = std::min(begin + chunkSize, drawCount);
+                futures.push_back(workers.Submit([&record, &inheritanceInfo, buffer = buffers[i], begin, end] {
+                    VkCommandBufferInheritanceInfo inheritance = inheritanceInfo;
+                    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+                    VkCommandBufferBeginInfo beginInfo = {
+                        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+                        .pInheritanceInfo = &inheritance
+                    };
+                    if (VkResult result = vkBeginCommandBuffer(buffer, &beginInfo)) {
+                        outStream << std::format("[ parallelRecorder ] ERROR\nFailed to begin a secondary command buffer!\nError code: {}\n", int32_t(result));
+                        return result;
+                    }
+                    record(buffer, begin, end);
+                    VkResult result = vkEndCommandBuffer(buffer);
+                    if (result)
+                        outStream << std::format("[ parallelRecorder ] ERROR\nFailed to end a secondary command buffer!\nError code: {}\n", int32_t(result));
+                    return result;
+                }));
+            }
+            //须等待所有分块录制完毕，录制函数和各命令缓冲区不得在录制期间失效
+            VkResult result = VK_SUCCESS;
+            for (auto& i : futures)
+                if (VkResult chunkResult = i.get())
+                    result = chunkResult;
+            if (result)
+                return result;
+            vkCmdExecuteCommands(primaryCommandBuffer, chunkCount, buffers.data());
+            return VK_SUCCESS;
+        }
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "threadPool.hpp"
+
+// Graphics Pipeline Library
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 基于VK_EXT_graphics_pipeline_library的管线拼装：四部分管线库各自只编译一次，新组合先快速链接以立即可用，
+    // 同时在后台做链接期优化，优化好的管线在帧边界由Update()换上，新材质组合不会造成卡顿
+    class graphicsPipelineLibrary {
+        inline static VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT features = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT };
+        inline static VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT properties = {
+            VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT };
+
+        struct linkedPipeline {
+            std::vector<VkPipeline> libraries;
+            VkPipelineLayout layout;
+            pipeline fastLinked;
+            pipeline optimized;            //由线程池写入
+            std::atomic<bool> optimizedReady = false;
+            bool upgraded = false;         //仅在渲染线程上读写
+            std::future<void> upgrade;
+        };
+        threadPool& pool;
+        std::mutex mutex;
+        std::map<std::pair<VkGraphicsPipelineLibraryFlagsEXT, uint64_t>, pipeline> parts;
+        std::unordered_multimap<uint64_t, std::unique_ptr<linkedPipeline>> linkedPipelines;
+        retiredObjects<pipeline> retiredPipelines;
+        uint32_t framesInFlight = 3;
+    public:
+        graphicsPipelineLibrary(threadPool& pool) :pool(pool) {}
+        graphicsPipelineLibrary(graphicsPipelineLibrary&&) = delete;
+        ~graphicsPipelineLibrary() {
+            //等待仍在后台链接的管线，它们引用着linkedPipelines中的对象
+            for (auto& i : linkedPipelines)
+                if (i.second->upgrade.valid())
+                    i.second->upgrade.wait();
+        }
+        //Static Function
+        //该函数须在创建逻辑设备前调用，物理设备支持时启用VK_EXT_graphics_pipeline_library
+        static void RequestDeviceExtension() {
+            graphicsBase::Base().AddOptionalDeviceExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+            graphicsBase::Base().AddOptionalDeviceExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, &features, &properties);
+        }
+        //不可用时应照常创建完整的管线
+        static bool Available() {
+            return graphicsBase::Base().IsDeviceExtensionEnabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+                features.graphicsPipelineLibrary;
+        }
+        //为false时快速链接不一定快，仍可使用，但最好提前链接
+        static bool FastLinking() {
+            return properties.graphicsPipelineLibraryFastLinking;
+        }
+        //Non-const Function
+        void FramesInFlight(uint32_t count) { framesInFlight = count; }
+        //取得一个管线库，(part, key)首次出现时用pack创建，key由调用者给出，用以区分同一部分的不同状态（比如顶点格式的散列）
+        VkPipeline Part(VkGraphicsPipelineLibraryFlagsEXT part, uint64_t key, graphicsPipelineCreateInfoPack& pack) {
+            std::lock_guard lock(mutex);
+            auto& library = parts[{ part, key }];
+            if (!library)
+                if (library.Create(pack.LibraryCreateInfo(part))) {
+                    parts.erase({ part, key });
+                    return VK_NULL_HANDLE;
+                }
+            return library;
+        }
+        //取得由libraries链接成的管线，首次调用时快速链接并在后台做链接期优化，优化完成前返回快速链接的管线
+        //返回的句柄在下次调用Update()前有效
+        VkPipeline Link(arrayRef<const VkPipeline> libraries, VkPipelineLayout layout) {
+            uint64_t hash = HashBytes(libraries.Pointer(), libraries.Count() * sizeof(VkPipeline), HashObject(layout));
+            std::lock_guard lock(mutex);
+            auto [begin, end] = linkedPipelines.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (auto& entry = *iterator->second;
+                    entry.layout == layout && std::ranges::equal(entry.libraries, libraries))
+                    return entry.upgraded ? entry.optimized : entry.fastLinked;
+            auto pEntry = std::make_unique<linkedPipeline>();
+            pEntry->libraries.assign(libraries.begin(), libraries.end());
+            pEntry->layout = layout;
+            if (pEntry->fastLinked.Link(libraries, layout))
+                return VK_NULL_HANDLE;
+            pEntry->upgrade = pool.Submit([pEntry = pEntry.get()] {
+                pipeline optimized;
+                if (optimized.Link({ pEntry->libraries.data(), pEntry->libraries.size() }, pEntry->layout, true))
+                    return; //优化失败则一直使用快速链接的管线
+                pEntry->optimized = std::move(optimized);
+                pEntry->optimizedReady.store(true, std::memory_order_release);
+            });
+            return linkedPipelines.emplace(hash, std::move(pEntry))->second->fastLinked;
+        }
+        //在帧边界调用，换上已优化好的管线，并销毁足够旧的快速链接管线
+        void Update() {
+            std::lock_guard lock(mutex);
+            retiredPipelines.NextFrame();
+            for (auto& [hash, pEntry] : linkedPipelines)
+                if (!pEntry->upgraded &&
+                    pEntry->optimizedReady.load(std::memory_order_acquire)) {
+                    pEntry->upgraded = true;
+                    retiredPipelines.Retire(std::move(pEntry->fastLinked), framesInFlight);
+                }
+        }
+    };
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "vkBase+.h"
+#include "threadPool.hpp"
+
+// Pipeline Warm-up Manifest
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 记录本次运行中实际用到的管线（以调用者给出的状态散列为键），退出时写入清单文件
+    // 下次启动时按清单在后台线程上预编译，先用到的、用得多的先编译，前几帧照常渲染，管线首次使用时不再卡顿
+    // 清单只存键，创建管线的方法须由程序在启动时用Register(...)登记（登记本身不编译）
+    class pipelineWarmup {
+    public:
+        using builder_t = std::function<result_t(pipeline&, VkPipelineCache)>;
+    private:
+        struct manifestEntry {
+            uint64_t useCount = 0;
+            uint64_t firstFrame = UINT64_MAX; //首次使用时的帧序号
+            bool usedThisRun = false;         //本次运行中用到过，首次用到时以本次的帧序号取代载入的
+        };
+        struct entry {
+            builder_t builder;
+            pipeline entryPipeline;
+            std::shared_future<VkResult> pending; //后台编译中或已编译完成
+        };
+        threadPool& pool;
+        pipelineCache cache;
+        std::mutex mutex;
+        std::unordered_map<uint64_t, entry> entries;
+        std::unordered_map<uint64_t, manifestEntry> manifest;
+        std::atomic<uint64_t> currentFrame = 0;
+        std::atomic<uint32_t> warmedUpCount = 0; //在锁外读取
+
+        std::shared_future<VkResult> Build(entry& entry) {
+            return entry.pending = pool.Submit([this, pEntry = &entry] {
+                pipeline newPipeline;
+                if (VkResult result = pEntry->builder(newPipeline, cache))
+                    return result;
+                pEntry->entryPipeline = std::move(newPipeline);
+                return VK_SUCCESS;
+            }).share();
+        }
+    public:
+        pipelineWarmup(threadPool& pool) :pool(pool) {}
+        pipelineWarmup(pipelineWarmup&&) = delete;
+        ~pipelineWarmup() {
+            for (auto& [key, entry] : entries)
+                if (entry.pending.valid())
+                    entry.pending.wait();
+        }
+        //Getter
+        VkPipelineCache Cache() const { return cache; }
+        //已被预编译的管线个数
+        uint32_t WarmedUpCount() const { return warmedUpCount; }
+        //Non-const Function
+        //登记一种管线，key应由决定管线的全部状态散列而来（如HashBytes(...)），builder须可在任意线程上调用
+        void Register(uint64_t key, builder_t builder) {
+            std::lock_guard lock(mutex);
+            entries[key].builder = std::move(builder);
+        }
+        //取得管线并记下一次使用，预编译尚未完成时等待之，未被预编译时当场创建
+        VkPipeline Get(uint64_t key) {
+            std::shared_future<VkResult> pending;
+            {
+                std::lock_guard lock(mutex);
+                auto iterator = entries.find(key);
+                if (iterator == entries.end()) {
+                    outStream << std::format("[ pipelineWarmup ] ERROR\nPipeline {:016x} is not registered!\n", key);
+                    return VK_NULL_HANDLE;
+                }
+                auto& [useCount, firstFrame, usedThisRun] = manifest[key];
+                useCount++;
+                if (!usedThisRun)
+                    firstFrame = currentFrame,
+                    usedThisRun = true;
+                auto& entry = iterator->second;
+                pending = entry.pending.valid() ? entry.pending : Build(entry);
+            }
+            //entries中元素的地址在插入后不变，可在锁外等待
+            if (pending.get())
+                return VK_NULL_HANDLE;
+            std::lock_guard lock(mutex);
+            return entries[key].entryPipeline;
+        }
+        //在每帧开始时调用，帧序号用以判定管线的使用先后
+        void NextFrame() { currentFrame++; }
+        //按清单提交预编译，应在登记完所有管线后、进入渲染循环前调用，maxCount限制提交个数
+        void WarmUp(uint32_t maxCount = UINT32_MAX) {
+            std::lock_guard lock(mutex);
+            std::vector<std::pair<uint64_t, manifestEntry>> order(manifest.begin(), manifest.end());
+            std::ranges::sort(order, [](const auto& a, const auto& b) {
+                return a.second.firstFrame != b.second.firstFrame ?
+                    a.second.firstFrame < b.second.firstFrame :
+                    a.second.useCount > b.second.useCount;
+            });
+            for (auto& [key, stats] : order) {
+                if (!maxCount)
+                    break;
+                auto iterator = entries.find(key);
+                if (iterator == entries.end() || iterator->second.pending.valid())
+                    continue; //清单中的管线可能已不再存在
+                Build(iterator->second);
+                warmedUpCount++, maxCount--;
+            }
+        }
+        //清单为文本文件，每行依次为键（十六进制）、使用次数、首次使用的帧序号
+        //上次的统计会与本次的合并（本次用到的管线，其首次使用的帧序号以本次为准），未用到的条目保留，以免偶尔未进入的场景被遗忘
+        result_t LoadManifest(const char* filepath) {
+            std::ifstream file(filepath);
+            if (!file)
+                return VK_SUCCESS; //首次运行时没有清单
+            std::lock_guard lock(mutex);
+            uint64_t key, useCount, firstFrame;
+            while (file >> std::hex >> key >> std::dec >> useCount >> firstFrame)
+                manifest[key] = { useCount, firstFrame };
+            //载入的使用次数减半后与本次的累加，长期不用的管线逐渐靠后
+            for (auto& [key, stats] : manifest)
+                stats.useCount = stats.useCount / 2;
+            return VK_SUCCESS;
+        }
+        result_t SaveManifest(const char* filepath) {
+            std::ofstream file(filepath);
+            if (!file) {
+                outStream << std::format("[ pipelineWarmup ] ERROR\nFailed to open the file: {}\n", filepath);
+                return VK_RESULT_MAX_ENUM;
+            }
+            std::lock_guard lock(mutex);
+            for (auto& [key, stats] : manifest)
+                file << std::format("{:016x} {} {}\n", key, stats.useCount, stats.firstFrame);
+            return VK_SUCCESS;
+        }
+        //管线缓存与清单配合：清单决定编译什么，缓存使编译本身更快，须在WarmUp()前调用
+        result_t LoadCache(const char* filepath) {
+            std::vector<uint8_t> data;
+            if (std::ifstream file(filepath, std::ios::ate | std::ios::binary); file) {
+                data.resize(size_t(file.tellg()));
+                file.seekg(0);
+                file.read(reinterpret_cast<char*>(data.data()), data.size());
+            }
+            return cache.Create(data);
+        }
+        result_t SaveCache(const char* filepath) const {
+            std::vector<uint8_t> data;
+            if (VkResult result = cache.GetData(data))
+                return result;
+            std::ofstream file(filepath, std::ios::binary);
+            if (!file) {
+                outStream << std::format("[ pipelineWarmup ] ERROR\nFailed to open the file: {}\n", filepath);
+                return VK_RESULT_MAX_ENUM;
+            }
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            return VK_SUCCESS;
+        }
+    };
+}
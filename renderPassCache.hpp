@@ -0,0 +1,164 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Render Pass and Framebuffer Cache
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 按内容驻留的渲染通道和帧缓冲，临时创建的离屏通道可复用已有的对象，不必每帧新建
+    // 渲染通道以附件、子通道、依赖的描述为键（不比较pNext链），帧缓冲以（渲染通道, image view, 尺寸, 层数）为键
+    // 帧缓冲引用的image view被销毁时（经imageView的析构器或重建交换链），帧缓冲被自动剔除，因此缓存须在这些image view全部销毁后才能析构
+    // 剔除的帧缓冲可能仍被在途的命令缓冲区引用，过framesInFlight帧（以BeginFrame()计）后才销毁
+    class renderPassCache {
+        struct renderPassEntry {
+            std::vector<uint32_t> key;
+            renderPass entryRenderPass;
+        };
+        struct framebufferEntry {
+            VkRenderPass renderPass;
+            std::vector<VkImageView> attachments;
+            VkExtent2D extent;
+            uint32_t layers;
+            framebuffer entryFramebuffer;
+        };
+        std::mutex mutex;
+        std::unordered_multimap<uint64_t, renderPassEntry> renderPasses;
+        std::unordered_multimap<uint64_t, framebufferEntry> framebuffers;
+        std::unordered_multimap<VkImageView, uint64_t> viewToFramebuffers; //image view到引用它的帧缓冲的散列
+        retiredObjects<framebuffer> retiredFramebuffers;
+        uint32_t framesInFlight;
+        uint64_t callbackId = 0; //graphicsBase中image view销毁回调的ID
+
+        template<typename T>
+        static void Append(std::vector<uint32_t>& key, const T& data) {
+            static_assert(sizeof(T) % 4 == 0);
+            key.insert(key.end(), reinterpret_cast<const uint32_t*>(&data), reinterpret_cast<const uint32_t*>(&data) + sizeof data / 4);
+        }
+        template<typename T>
+        static void Append(std::vector<uint32_t>& key, const T* pData, uint32_t count) {
+            key.push_back(pData ? count : 0);
+            for (uint32_t i = 0; pData && i < count; i++)
+                Append(key, pData[i]);
+        }
+        //VkAttachmentDescription、VkAttachmentReference、VkSubpassDependency的成员均为4字节，无填充字节，可直接按字节序列化
+        static std::vector<uint32_t> Key(const VkRenderPassCreateInfo& createInfo) {
+            std::vector<uint32_t> key;
+            key.push_back(createInfo.flags);
+            Append(key, createInfo.pAttachments, createInfo.attachmentCount);
+            key.push_back(createInfo.subpassCount);
+            for (uint32_t i = 0; i < createInfo.subpassCount; i++) {
+                auto& subpass = createInfo.pSubpasses[i];
+                key.push_back(subpass.flags);
+                key.push_back(subpass.pipelineBindPoint);
+                Append(key, subpass.pInputAttachments, subpass.inputAttachmentCount);
+                Append(key, subpass.pColorAttachments, subpass.colorAttachmentCount);
+                Append(key, subpass.pResolveAttachments, subpass.colorAttachmentCount);
+                Append(key, subpass.pDepthStencilAttachment, 1);
+                Append(key, subpass.pPreserveAttachments, subpass.preserveAttachmentCount);
+            }
+            Append(key, createInfo.pDependencies, createInfo.dependencyCount);
+            return key;
+        }
+        static uint64_t FramebufferHash(VkRenderPass renderPass, arrayRef<const VkImageView> attachments, VkExtent2D extent, uint32_t layers) {
+            uint64_t hash = HashObject(renderPass);
+            hash = HashBytes(attachments.Pointer(), attachments.Count() * sizeof(VkImageView), hash);
+            hash = HashObject(extent, hash);
+            return HashObject(layers, hash);
+        }
+        void Evict(VkImageView view) {
+            std::lock_guard lock(mutex);
+            std::vector<uint64_t> hashes;
+            auto [begin, end] = viewToFramebuffers.equal_range(view);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                hashes.push_back(iterator->second);
+            for (uint64_t hash : hashes) {
+                for (auto [iterator, end] = framebuffers.equal_range(hash); iterator != end;) {
+                    auto& attachments = iterator->second.attachments;
+                    if (std::ranges::find(attachments, view) == attachments.end()) {
+                        ++iterator;
+                        continue;
+                    }
+                    //一并去掉该帧缓冲的其他image view到它的映射
+                    for (auto other : attachments)
+                        if (other != view)
+                            for (auto [i, end] = viewToFramebuffers.equal_range(other); i != end;)
+                                i = i->second == hash ? viewToFramebuffers.erase(i) : std::next(i);
+                    retiredFramebuffers.Retire(std::move(iterator->second.entryFramebuffer), framesInFlight);
+                    iterator = framebuffers.erase(iterator);
+                }
+            }
+            viewToFramebuffers.erase(view);
+        }
+    public:
+        renderPassCache(uint32_t framesInFlight = 3) :framesInFlight(framesInFlight) {
+            callbackId = graphicsBase::Base().AddCallback_DestroyImageView([this](VkImageView view) { Evict(view); });
+        }
+        renderPassCache(renderPassCache&&) = delete;
+        ~renderPassCache() {
+            graphicsBase::Base().RemoveCallback_DestroyImageView(callbackId);
+        }
+        //Getter
+        size_t RenderPassCount() {
+            std::lock_guard lock(mutex);
+            return renderPasses.size();
+        }
+        size_t FramebufferCount() {
+            std::lock_guard lock(mutex);
+            return framebuffers.size();
+        }
+        //Non-const Function
+        //取得与createInfo描述一致的渲染通道，不存在时创建
+        VkRenderPass RenderPass(VkRenderPassCreateInfo& createInfo) {
+            std::vector<uint32_t> key = Key(createInfo);
+            uint64_t hash = HashBytes(key.data(), key.size() * 4);
+            std::lock_guard lock(mutex);
+            auto [begin, end] = renderPasses.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (iterator->second.key == key)
+                    return iterator->second.entryRenderPass;
+            renderPass newRenderPass;
+            if (newRenderPass.Create(createInfo))
+                return VK_NULL_HANDLE;
+            return renderPasses.emplace(hash, renderPassEntry{ std::move(key), std::move(newRenderPass) })->second.entryRenderPass;
+        }
+        //取得帧缓冲，不存在时创建
+        VkFramebuffer Framebuffer(VkRenderPass renderPass, arrayRef<const VkImageView> attachments, VkExtent2D extent, uint32_t layers = 1) {
+            uint64_t hash = FramebufferHash(renderPass, attachments, extent, layers);
+            std::lock_guard lock(mutex);
+            auto [begin, end] = framebuffers.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (auto& entry = iterator->second;
+                    entry.renderPass == renderPass && std::ranges::equal(entry.attachments, attachments) &&
+                    entry.extent.width == extent.width && entry.extent.height == extent.height && entry.layers == layers)
+                    return entry.entryFramebuffer;
+            VkFramebufferCreateInfo createInfo = {
+                .renderPass = renderPass,
+                .attachmentCount = uint32_t(attachments.Count()),
+                .pAttachments = attachments.Pointer(),
+                .width = extent.width,
+                .height = extent.height,
+                .layers = layers
+            };
+            framebuffer newFramebuffer;
+            if (newFramebuffer.Create(createInfo))
+                return VK_NULL_HANDLE;
+            for (auto& i : attachments)
+                viewToFramebuffers.emplace(i, hash);
+            return framebuffers.emplace(hash, framebufferEntry{
+                renderPass, { attachments.begin(), attachments.end() }, extent, layers, std::move(newFramebuffer) })->second.entryFramebuffer;
+        }
+        //在每帧开始时（栅栏等待之后）调用，销毁足够旧的被剔除的帧缓冲
+        void BeginFrame() {
+            std::lock_guard lock(mutex);
+            retiredFramebuffers.NextFrame();
+        }
+        //销毁所有帧缓冲，渲染通道保留，调用前需确保帧缓冲不再被使用
+        void ClearFramebuffers() {
+            std::lock_guard lock(mutex);
+            framebuffers.clear();
+            viewToFramebuffers.clear();
+        }
+    };
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Resource State Tracking
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 记录各缓冲区、图像（逐mip等级、逐图层）最近的访问及内存布局，命令声明其用法时算出所需的最少的synchronization2屏障
+    // 屏障先攒着，在下一个动作命令（绘制、调度、复制等）前调用Flush(...)，合并为一次vkCmdPipelineBarrier2(...)
+    // 读后读不需屏障；写后读只在写入对该阶段及访问尚不可见时才需内存屏障，同一写入对多个读取者只同步一次；读后写只需执行依赖
+    // 状态跨命令缓冲区保留，须按提交顺序在同一队列上使用，非线程安全
+    // 同一命令对同一资源的多种用法应合并为一次声明（阶段和访问取并集），否则两者间的屏障会落在同一次Flush(...)中而不起作用
+    // 渲染通道通过附件描述自行转换布局，在渲染通道外改变资源状态的操作（包括渲染通道本身）须以SetImageState(...)告知
+    class resourceStateTracker {
+    public:
+        struct usage {
+            VkPipelineStageFlags2 stages;
+            VkAccessFlags2 accesses;
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED; //仅用于图像
+        };
+        static constexpr VkAccessFlags2 writeAccesses =
+            VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+            VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT |
+            VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+    private:
+        //屏障使写入对目标阶段中的目标访问可见，阶段和访问须成对记录，分属两个屏障的阶段和访问不能拼凑出可见性
+        struct visibleScope {
+            VkPipelineStageFlags2 stages;
+            VkAccessFlags2 accesses;
+            bool operator==(const visibleScope&) const = default;
+            bool Covers(const usage& use) const { return !(use.stages & ~stages) && !(use.accesses & ~accesses); }
+        };
+        static constexpr uint32_t maxVisibleScopeCount = 4;
+        struct accessState {
+            VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            bool written = false;                                  //有需同步的写入（含布局转换）
+            VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 writeAccesses = VK_ACCESS_2_NONE;
+            visibleScope visibleScopes[maxVisibleScopeCount] = {};         //写入后的各屏障使写入可见的范围，超出个数时丢弃最早的（只会多出屏障）
+            uint32_t visibleScopeCount = 0;
+            VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;    //写入后读取过的阶段，之后的写入须等它们执行完
+            bool operator==(const accessState&) const = default;
+        };
+        struct imageState {
+            VkImageAspectFlags aspectMask;
+            uint32_t mipLevelCount;
+            uint32_t arrayLayerCount;
+            std::vector<accessState> subresources; //[mip等级 * arrayLayerCount + 图层]
+        };
+        struct barrierInfo {
+            VkPipelineStageFlags2 srcStages;
+            VkAccessFlags2 srcAccesses;
+            VkImageLayout oldLayout;
+        };
+        std::unordered_map<VkBuffer, accessState> bufferStates;
+        std::unordered_map<VkImage, imageState> imageStates;
+        std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+        std::vector<VkImageMemoryBarrier2> imageBarriers;
+        uint64_t barrierCount = 0;
+        uint64_t flushCount = 0;
+
+        //按访问更新状态，需要屏障时返回true并填写源阶段、源访问及旧布局
+        static bool Transition(accessState& state, const usage& use, bool isImage, bool discard, barrierInfo& info) {
+            bool write = use.accesses & writeAccesses;
+            bool layoutChange = isImage && state.layout != use.layout;
+            info = { state.writeStages | state.readStages, state.writeAccesses, discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout };
+            bool needBarrier;
+            if (write || layoutChange) {
+                needBarrier = state.written || state.readStages || layoutChange;
+                //布局转换本身是写入，随屏障对目标阶段可见，之后其他阶段的访问仍须等待它
+                state.written = write || layoutChange;
+                state.writeStages = use.stages;
+                state.writeAccesses = write ? use.accesses & writeAccesses : VK_ACCESS_2_NONE;
+                std::ranges::fill(state.visibleScopes, visibleScope{});
+                state.visibleScopeCount = !write;
+                if (!write)
+                    state.visibleScopes[0] = { use.stages, use.accesses };
+                state.readStages = write ? VK_PIPELINE_STAGE_2_NONE : use.stages;
+                state.layout = isImage ? use.layout : VK_IMAGE_LAYOUT_UNDEFINED;
+                return needBarrier;
+            }
+            needBarrier = state.written &&
+                std::ranges::none_of(state.visibleScopes, state.visibleScopes + state.visibleScopeCount,
+                    [&use](const visibleScope& scope) { return scope.Covers(use); });
+            if (needBarrier) {
+                info.srcStages = state.writeStages;
+                if (state.visibleScopeCount == maxVisibleScopeCount)
+                    std::shift_left(state.visibleScopes, state.visibleScopes + maxVisibleScopeCount, 1),
+                    state.visibleScopeCount--;
+                state.visibleScopes[state.visibleScopeCount++] = { use.stages, use.accesses };
+            }
+            state.readStages |= use.stages;
+            return needBarrier;
+        }
+        void PushImageBarrier(VkImage image, const imageState& imageInfo, const barrierInfo& info, const usage& use,
+            uint32_t baseMipLevel, uint32_t mipLevelCount, uint32_t baseArrayLayer, uint32_t arrayLayerCount) {
+            imageBarriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = info.srcStages,
+                .srcAccessMask = info.srcAccesses,
+                .dstStageMask = use.stages,
+                .dstAccessMask = use.accesses,
+                .oldLayout = info.oldLayout,
+                .newLayout = use.layout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = { imageInfo.aspectMask, baseMipLevel, mipLevelCount, baseArrayLayer, arrayLayerCount } });
+        }
+        //将范围内的mip等级和图层限制在图像之内
+        static void Clamp(const imageState& imageInfo, VkImageSubresourceRange& range) {
+            range.baseMipLevel = std::min(range.baseMipLevel, imageInfo.mipLevelCount);
+            range.baseArrayLayer = std::min(range.baseArrayLayer, imageInfo.arrayLayerCount);
+            range.levelCount = std::min(range.levelCount, imageInfo.mipLevelCount - range.baseMipLevel);
+            range.layerCount = std::min(range.layerCount, imageInfo.arrayLayerCount - range.baseArrayLayer);
+        }
+    public:
+        resourceStateTracker() = default;
+        resourceStateTracker(resourceStateTracker&&) = default;
+        //Getter
+        size_t PendingBarrierCount() const { return bufferBarriers.size() + imageBarriers.size(); }
+        //已录制的屏障数及vkCmdPipelineBarrier2(...)的调用数
+        uint64_t BarrierCount() const { return barrierCount; }
+        uint64_t FlushCount() const { return flushCount; }
+        //Non-const Function
+        //图像须先登记才能被跟踪，currentLayout为其当前的内存布局（新建的图像为VK_IMAGE_LAYOUT_UNDEFINED）
+        void RegisterImage(VkImage image, VkImageAspectFlags aspectMask, uint32_t mipLevelCount = 1, uint32_t arrayLayerCount = 1,
+            VkImageLayout currentLayout = VK_IMAGE_LAYOUT_UNDEFINED) {
+            imageStates[image] = {
+                aspectMask, mipLevelCount, arrayLayerCount,
+                std::vector<accessState>(size_t(mipLevelCount) * arrayLayerCount, { currentLayout }) };
+        }
+        //资源被销毁前调用
+        void Forget(VkBuffer buffer) { bufferStates.erase(buffer); }
+        void Forget(VkImage image) { imageStates.erase(image); }
+        //声明下一个命令对缓冲区的用法，缓冲区作为整体跟踪，屏障也总是覆盖整个缓冲区（否则其余部分会被误认为已可见）
+        void UseBuffer(VkBuffer buffer, const usage& use) {
+            barrierInfo info;
+            if (!Transition(bufferStates[buffer], use, false, false, info))
+                return;
+            bufferBarriers.push_back({
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .srcStageMask = info.srcStages,
+                .srcAccessMask = info.srcAccesses,
+                .dstStageMask = use.stages,
+                .dstAccessMask = use.accesses,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = buffer,
+                .offset = 0,
+                .size = VK_WHOLE_SIZE });
+        }
+        //声明下一个命令对图像的用法，use.layout为该命令所需的布局，discard为true时不保留原有内容（以VK_IMAGE_LAYOUT_UNDEFINED为旧布局）
+        //范围内各子资源状态一致时只产生一个屏障，否则每个mip等级一个，mip等级内各图层也不一致时逐图层产生
+        void UseImage(VkImage image, const usage& use, VkImageSubresourceRange range = { 0, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS },
+            bool discard = false) {
+            auto iterator = imageStates.find(image);
+            if (iterator == imageStates.end()) {
+                outStream << std::format("[ resourceStateTracker ] ERROR\nThe image is not registered, call RegisterImage(...) first!\n");
+                return;
+            }
+            auto& imageInfo = iterator->second;
+            Clamp(imageInfo, range);
+            if (!range.levelCount || !range.layerCount)
+                return;
+            auto Subresource = [&](uint32_t mipLevel, uint32_t arrayLayer) -> accessState& {
+                return imageInfo.subresources[size_t(mipLevel) * imageInfo.arrayLayerCount + arrayLayer];
+            };
+            auto Uniform = [&](uint32_t baseMipLevel, uint32_t mipLevelCount) {
+                const accessState& first = Subresource(baseMipLevel, range.baseArrayLayer);
+                for (uint32_t mip = baseMipLevel; mip < baseMipLevel + mipLevelCount; mip++)
+                    for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+                        if (!(Subresource(mip, layer) == first))
+                            return false;
+                return true;
+            };
+            //对状态一致的一组子资源，以第一个算出屏障，其余照样更新
+            auto TransitionGroup = [&](uint32_t baseMipLevel, uint32_t mipLevelCount, uint32_t baseArrayLayer, uint32_t arrayLayerCount) {
+                barrierInfo info;
+                bool needBarrier = false;
+                for (uint32_t mip = baseMipLevel; mip < baseMipLevel + mipLevelCount; mip++)
+                    for (uint32_t layer = baseArrayLayer; layer < baseArrayLayer + arrayLayerCount; layer++)
+                        needBarrier = Transition(Subresource(mip, layer), use, true, discard, info);
+                if (needBarrier)
+                    PushImageBarrier(image, imageInfo, info, use, baseMipLevel, mipLevelCount, baseArrayLayer, arrayLayerCount);
+            };
+            if (Uniform(range.baseMipLevel, range.levelCount)) {
+                TransitionGroup(range.baseMipLevel, range.levelCount, range.baseArrayLayer, range.layerCount);
+                return;
+            }
+            for (uint32_t mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++)
+                if (Uniform(mip, 1))
+                    TransitionGroup(mip, 1, range.baseArrayLayer, range.layerCount);
+                else
+                    for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+                        TransitionGroup(mip, 1, layer, 1);
+        }
+        //告知跟踪器，图像已由其他途径（如渲染通道的附件描述）转换为layout，并由stages中的accesses写入
+        void SetImageState(VkImage image, VkImageLayout layout, VkPipelineStageFlags2 stages, VkAccessFlags2 accesses,
+            VkImageSubresourceRange range = { 0, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS }) {
+            auto iterator = imageStates.find(image);
+            if (iterator == imageStates.end()) {
+                outStream << std::format("[ resourceStateTracker ] ERROR\nThe image is not registered, call RegisterImage(...) first!\n");
+                return;
+            }
+            auto& imageInfo = iterator->second;
+            Clamp(imageInfo, range);
+            for (uint32_t mip = range.baseMipLevel; mip < range.baseMipLevel + range.levelCount; mip++)
+                for (uint32_t layer = range.baseArrayLayer; layer < range.baseArrayLayer + range.layerCount; layer++)
+                    imageInfo.subresources[size_t(mip) * imageInfo.arrayLayerCount + layer] = {
+                        .layout = layout,
+                        .written = true,
+                        .writeStages = stages,
+                        .writeAccesses = accesses & writeAccesses };
+        }
+        //将攒下的屏障合并为一次vkCmdPipelineBarrier2(...)，在动作命令前调用，没有屏障时什么也不做
+        void Flush(VkCommandBuffer commandBuffer) {
+            if (bufferBarriers.empty() && imageBarriers.empty())
+                return;
+            VkDependencyInfo dependencyInfo = {
+                .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount = uint32_t(bufferBarriers.size()),
+                .pBufferMemoryBarriers = bufferBarriers.data(),
+                .imageMemoryBarrierCount = uint32_t(imageBarriers.size()),
+                .pImageMemoryBarriers = imageBarriers.data()
+            };
+            vkCmdPipelineBarrier2(commandBuffer, &dependencyInfo);
+            barrierCount += bufferBarriers.size() + imageBarriers.size();
+            flushCount++;
+            bufferBarriers.clear();
+            imageBarriers.clear();
+        }
+        //Static Function
+        //需Vulkan1.3的synchronization2特性
+        static bool Available() {
+            return graphicsBase::Base().DeviceApiVersion() >= VK_API_VERSION_1_3 &&
+                graphicsBase::Base().PhysicalDeviceVulkan13Features().synchronization2;
+        }
+        //常用的用法
+        static constexpr usage VertexBuffer() { return { VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT }; }
+        static constexpr usage IndexBuffer() { return { VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT, VK_ACCESS_2_INDEX_READ_BIT }; }
+        static constexpr usage IndirectBuffer() { return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT }; }
+        static constexpr usage UniformBuffer(VkPipelineStageFlags2 stages) { return { stages, VK_ACCESS_2_UNIFORM_READ_BIT }; }
+        static constexpr usage StorageRead(VkPipelineStageFlags2 stages) { return { stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT }; }
+        static constexpr usage StorageWrite(VkPipelineStageFlags2 stages) {
+            return { stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+        }
+        static constexpr usage StorageImage(VkPipelineStageFlags2 stages, bool write) {
+            return { stages, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | (write ? VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT : VK_ACCESS_2_NONE), VK_IMAGE_LAYOUT_GENERAL };
+        }
+        static constexpr usage SampledImage(VkPipelineStageFlags2 stages) {
+            return { stages, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+        }
+        static constexpr usage ColorAttachment() {
+            return {
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+        }
+        static constexpr usage DepthStencilAttachment() {
+            return {
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+        }
+        static constexpr usage TransferSrc(bool isImage = false) {
+            return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, isImage ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED };
+        }
+        static constexpr usage TransferDst(bool isImage = false) {
+            return { VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, isImage ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED };
+        }
+        //呈现前转换布局，无需目标访问（由信号量同步）
+        //阶段记为VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT，使图像被再次取得后，下一次布局转换以该阶段为源阶段，与在该阶段等待的取得图像的信号量构成依赖链
+        static constexpr usage Present() { return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR }; }
+    };
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+#include "vkBase.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// Shader Hot Reload
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 监视着色器目录，在工作线程上重建改动过的shader module及依赖它们的管线，新管线在帧边界由渲染线程换上
+    // 重建失败（读文件、编译、创建shader module或管线任一步出错）时保留上一次成功的结果
+    class shaderHotReloader {
+    public:
+        struct shaderStage {
+            std::string path; //.spv文件路径
+            VkShaderStageFlagBits stage;
+            const char* entry = "main";
+        };
+        //builder会在渲染线程（首次创建、重建交换链时）和工作线程（热重载时）上被调用，因此不应修改共享状态
+        using builder_t = std::function<result_t(pipeline&, std::span<const VkPipelineShaderStageCreateInfo>)>;
+    private:
+        struct pipelineEntry {
+            pipeline* pTarget;
+            std::vector<shaderStage> stages;
+            builder_t builder;
+            uint64_t generation = 0; //每次在渲染线程上同步重建后递增，用于丢弃基于旧状态建出来的管线
+        };
+        struct pendingPipeline {
+            pipeline* pTarget;
+            uint64_t generation;
+            pipeline newPipeline;
+        };
+
+        std::mutex mutex; //保护以下所有容器
+        std::unordered_map<std::string, std::shared_ptr<shaderModule>> modules; //键为规范化的绝对路径
+        std::vector<pipelineEntry> pipelines;
+        std::vector<pendingPipeline> pendingPipelines;
+        retiredObjects<pipeline> retiredPipelines;
+        uint32_t framesInFlight = 3; //被换下的管线可能仍被在途的命令缓冲区引用，过这么多帧再销毁
+
+        std::filesystem::path directory;
+        std::string compileCommand;
+        std::thread worker;
+        std::atomic<bool> stopping = false;
+
+        static std::string Key(const std::filesystem::path& path) {
+            return std::filesystem::absolute(path).lexically_normal().string();
+        }
+        static const char* Profile(VkShaderStageFlagBits stage) {
+            switch (stage) {
+            case VK_SHADER_STAGE_VERTEX_BIT: return "vs_6_0";
+            case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT: return "hs_6_0";
+            case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT: return "ds_6_0";
+            case VK_SHADER_STAGE_GEOMETRY_BIT: return "gs_6_0";
+            case VK_SHADER_STAGE_FRAGMENT_BIT: return "ps_6_0";
+            case VK_SHADER_STAGE_COMPUTE_BIT: return "cs_6_0";
+            default: return "";
+            }
+        }
+        //读取SPIR-V并创建shader module，失败时返回空指针
+        static std::shared_ptr<shaderModule> LoadModule(const std::string& path) {
+            std::vector<uint32_t> code;
+            if (shaderModule::ReadCode(path.c_str(), code))
+                return {};
+            //编译器尚未写完文件时可能读到不完整的字节码，检查魔数和长度
+            if (code.size() < 5 || code[0] != 0x07230203) {
+                outStream << std::format("[ shaderHotReloader ] ERROR\nInvalid SPIR-V binary: {}\n", path);
+                return {};
+            }
+            auto pModule = std::make_shared<shaderModule>();
+            if (pModule->Create(code.size() * 4, code.data()))
+                return {};
+            return pModule;
+        }
+        static std::vector<VkPipelineShaderStageCreateInfo> StageCreateInfos(const std::vector<shaderStage>& stages, const std::vector<std::shared_ptr<shaderModule>>& stageModules) {
+            std::vector<VkPipelineShaderStageCreateInfo> createInfos;
+            for (size_t i = 0; i < stages.size(); i++)
+                createInfos.push_back(stageModules[i]->StageCreateInfo(stages[i].stage, stages[i].entry));
+            return createInfos;
+        }
+
+        //将改动过的HLSL编译为同名的.spv，生成的.spv会再次触发文件改动，由ReloadSpirv(...)接着处理
+        void CompileHlsl(const std::filesystem::path& source) {
+            std::filesystem::path spirv = source;
+            spirv.replace_extension(".spv");
+            const char* profile = nullptr;
+            const char* entry = nullptr;
+            {
+                std::lock_guard lock(mutex);
+                for (auto& i : pipelines)
+                    for (auto& j : i.stages)
+                        if (Key(j.path) == Key(spirv))
+                            profile = Profile(j.stage),
+                            entry = j.entry;
+            }
+            if (!profile)
+                return;
+            std::string sourceString = source.string(), spirvString = spirv.string();
+            std::string command = std::vformat(compileCommand, std::make_format_args(sourceString, spirvString, profile, entry));
+            if (int exitCode = std::system(command.c_str()))
+                outStream << std::format("[ shaderHotReloader ] ERROR\nFailed to compile {}, keeping the last good pipeline!\nExit code: {}\n", sourceString, exitCode);
+        }
+        void ReloadSpirv(const std::filesystem::path& path) {
+            std::string key = Key(path);
+            struct job {
+                pipeline* pTarget;
+                uint64_t generation;
+                std::vector<shaderStage> stages;
+                std::vector<std::shared_ptr<shaderModule>> stageModules;
+                builder_t builder;
+            };
+            std::vector<job> jobs;
+            {
+                std::lock_guard lock(mutex);
+                if (!modules.contains(key))
+                    return;
+                for (auto& i : pipelines)
+                    for (auto& j : i.stages)
+                        if (Key(j.path) == key) {
+                            jobs.emplace_back(i.pTarget, i.generation, i.stages, std::vector<std::shared_ptr<shaderModule>>{}, i.builder);
+                            break;
+                        }
+            }
+            auto pNewModule = LoadModule(key);
+            if (!pNewModule) {
+                outStream << std::format("[ shaderHotReloader ] ERROR\nFailed to reload {}, keeping the last good pipeline!\n", key);
+                return;
+            }
+            //在锁外创建管线，不阻塞渲染线程
+            std::vector<pendingPipeline> builtPipelines;
+            for (auto& i : jobs) {
+                {
+                    std::lock_guard lock(mutex);
+                    for (auto& j : i.stages)
+                        i.stageModules.push_back(Key(j.path) == key ? pNewModule : modules[Key(j.path)]);
+                }
+                pipeline newPipeline;
+                auto stageCreateInfos = StageCreateInfos(i.stages, i.stageModules);
+                if (i.builder(newPipeline, stageCreateInfos)) {
+                    outStream << std::format("[ shaderHotReloader ] ERROR\nFailed to rebuild a pipeline depending on {}, keeping the last good pipeline!\n", key);
+                    return;
+                }
+                builtPipelines.emplace_back(i.pTarget, i.generation, std::move(newPipeline));
+            }
+            //所有依赖的管线都建好后才换上新的shader module，使渲染线程上的重建与热重载的结果一致
+            std::lock_guard lock(mutex);
+            modules[key] = std::move(pNewModule);
+            for (auto& i : builtPipelines) {
+                std::erase_if(pendingPipelines, [&](const pendingPipeline& pending) { return pending.pTarget == i.pTarget; });
+                pendingPipelines.push_back(std::move(i));
+            }
+            outStream << std::format("[ shaderHotReloader ] Reloaded {}\n", key);
+        }
+        void ProcessChange(const std::filesystem::path& path) {
+            if (path.extension() == ".spv")
+                ReloadSpirv(path);
+            else if (path.extension() == ".hlsl" && compileCommand.size())
+                CompileHlsl(path);
+        }
+
+        void Watch_Internal() {
+#ifdef __linux__
+            int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (fd < 0 ||
+                inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+                outStream << std::format("[ shaderHotReloader ] ERROR\nFailed to watch the directory: {}\n", directory.string());
+                if (fd >= 0)
+                    close(fd);
+                return;
+            }
+            while (!stopping) {
+                pollfd pollFd = { fd, POLLIN };
+                if (poll(&pollFd, 1, 100) <= 0)
+                    continue;
+                //编辑器保存一次可能产生多个事件，同一批事件中的文件只处理一次
+                std::set<std::filesystem::path> changedFiles;
+                alignas(inotify_event) char buffer[4096];
+                for (ssize_t length; (length = read(fd, buffer, sizeof buffer)) > 0;)
+                    for (char* p = buffer; p < buffer + length;) {
+                        auto pEvent = reinterpret_cast<const inotify_event*>(p);
+                        if (pEvent->len)
+                            changedFiles.insert(directory / pEvent->name);
+                        p += sizeof(inotify_event) + pEvent->len;
+                    }
+                for (auto& i : changedFiles)
+                    ProcessChange(i);
+            }
+            close(fd);
+#else
+            //没有inotify的平台上轮询文件的修改时间
+            std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes;
+            auto Scan = [&](bool notify) {
+                std::error_code errorCode;
+                for (auto& i : std::filesystem::directory_iterator(directory, errorCode)) {
+                    auto writeTime = i.last_write_time(errorCode);
+                    if (errorCode)
+                        continue;
+                    auto& recordedTime = writeTimes[i.path().string()];
+                    if (recordedTime != writeTime) {
+                        recordedTime = writeTime;
+                        if (notify)
+                            ProcessChange(i.path());
+                    }
+                }
+            };
+            Scan(false);
+            while (!stopping) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(250));
+                Scan(true);
+            }
+#endif
+        }
+    public:
+        shaderHotReloader() = default;
+        shaderHotReloader(shaderHotReloader&&) = delete;
+        ~shaderHotReloader() {
+            Stop();
+        }
+        //Getter
+        uint32_t FramesInFlight() const { return framesInFlight; }
+        //Non-const Function
+        void FramesInFlight(uint32_t count) { framesInFlight = count; }
+        //开始监视目录，compileCommand非空时，改动过的.hlsl会被该命令编译为同名的.spv
+        //compileCommand中{0}为.hlsl路径，{1}为.spv路径，{2}为着色器模型（如vs_6_0），{3}为入口函数名
+        //例："dxc -spirv -T {2} -E {3} {0} -Fo {1}"
+        void Watch(const std::filesystem::path& directory, std::string_view compileCommand = {}) {
+            Stop();
+            this->directory = directory;
+            this->compileCommand = compileCommand;
+            stopping = false;
+            worker = std::thread([this] { Watch_Internal(); });
+        }
+        void Stop() {
+            stopping = true;
+            if (worker.joinable())
+                worker.join();
+        }
+        //注册一条依赖stages中着色器的管线，着色器在此时被加载，管线需随后用CreatePipeline(...)创建
+        result_t AddPipeline(pipeline& target, std::vector<shaderStage> stages, builder_t builder) {
+            std::lock_guard lock(mutex);
+            for (auto& i : stages)
+                if (auto& pModule = modules[Key(i.path)]; !pModule)
+                    if (!(pModule = LoadModule(Key(i.path)))) {
+                        modules.erase(Key(i.path));
+                        return VK_RESULT_MAX_ENUM;
+                    }
+            pipelines.emplace_back(&target, std::move(stages), std::move(builder));
+            return VK_SUCCESS;
+        }
+        //在渲染线程上用当前的shader module同步创建管线，用于首次创建和重建交换链后
+        result_t CreatePipeline(pipeline& target) {
+            std::lock_guard lock(mutex);
+            for (auto& i : pipelines)
+                if (i.pTarget == &target) {
+                    i.generation++;
+                    std::vector<std::shared_ptr<shaderModule>> stageModules;
+                    for (auto& j : i.stages)
+                        stageModules.push_back(modules[Key(j.path)]);
+                    auto stageCreateInfos = StageCreateInfos(i.stages, stageModules);
+                    return i.builder(target, stageCreateInfos);
+                }
+            outStream << std::format("[ shaderHotReloader ] ERROR\nThe pipeline wasn't added to the reloader!\n");
+            return VK_RESULT_MAX_ENUM;
+        }
+        //在帧边界（栅栏等待之后、录制命令之前）调用，换上已重建好的管线，并销毁足够旧的管线
+        void ApplyPendingUpdates() {
+            std::lock_guard lock(mutex);
+            retiredPipelines.NextFrame();
+            for (auto& i : pendingPipelines) {
+                bool upToDate = false;
+                for (auto& j : pipelines)
+                    if (j.pTarget == i.pTarget)
+                        upToDate = j.generation == i.generation;
+                //交换链在此期间被重建过，这条管线基于旧状态，丢弃（当前的管线已使用新的shader module）
+                if (!upToDate)
+                    continue;
+                retiredPipelines.Retire(std::move(*i.pTarget), framesInFlight);
+                *i.pTarget = std::move(i.newPipeline);
+            }
+            pendingPipelines.clear();
+        }
+    };
+}
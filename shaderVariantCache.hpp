@@ -0,0 +1,132 @@
+#pragma once
+
+#include "vkBase+.h"
+
+// Specialized Shader Variants
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 以（shader module, 入口函数, 特化常量）为键缓存特化后的管线，首次用到某一组合时才创建管线
+    // 用特化常量在管线编译期定下循环次数、功能开关、工作组大小等，代替在着色器中分支的“超级着色器”
+    // 键中的module是句柄值，销毁后可能被新建的module重用，销毁module前须以Forget(...)移除以其为键的变体（如热重载时）
+    class shaderVariantCache {
+    public:
+        struct shaderStage {
+            VkShaderModule module;
+            VkShaderStageFlagBits stage;
+            const char* entry = "main";
+            const VkSpecializationInfo* pSpecializationInfo = nullptr;
+        };
+        //builder用给定的着色器阶段创建管线，其余状态由builder自行决定
+        using builder_t = std::function<result_t(pipeline&, std::span<const VkPipelineShaderStageCreateInfo>)>;
+    private:
+        struct variant {
+            std::vector<uint8_t> key; //完整的键，用于排除散列冲突
+            std::vector<VkShaderModule> modules;
+            pipeline variantPipeline;
+        };
+        std::mutex mutex;
+        std::unordered_multimap<uint64_t, variant> variants;
+        retiredObjects<pipeline> retiredPipelines;
+        uint32_t framesInFlight = 3;
+
+        template<typename T>
+        static void Append(std::vector<uint8_t>& key, const T& data) {
+            key.insert(key.end(), reinterpret_cast<const uint8_t*>(&data), reinterpret_cast<const uint8_t*>(&data) + sizeof data);
+        }
+        //将各阶段的module、入口函数名、特化常量的映射和数据序列化为键
+        static std::vector<uint8_t> Key(std::span<const shaderStage> stages, uint64_t stateKey) {
+            std::vector<uint8_t> key;
+            Append(key, stateKey);
+            for (auto& i : stages) {
+                Append(key, i.module);
+                Append(key, i.stage);
+                key.insert(key.end(), i.entry, i.entry + strlen(i.entry) + 1);
+                if (!i.pSpecializationInfo) {
+                    Append(key, uint32_t(0));
+                    continue;
+                }
+                auto& info = *i.pSpecializationInfo;
+                Append(key, info.mapEntryCount);
+                for (uint32_t j = 0; j < info.mapEntryCount; j++)
+                    Append(key, info.pMapEntries[j].constantID),
+                    Append(key, info.pMapEntries[j].offset),
+                    Append(key, uint64_t(info.pMapEntries[j].size));
+                Append(key, uint64_t(info.dataSize));
+                key.insert(key.end(), static_cast<const uint8_t*>(info.pData), static_cast<const uint8_t*>(info.pData) + info.dataSize);
+            }
+            return key;
+        }
+        VkPipeline Find(uint64_t hash, const std::vector<uint8_t>& key) {
+            auto [begin, end] = variants.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (iterator->second.key == key)
+                    return iterator->second.variantPipeline;
+            return VK_NULL_HANDLE;
+        }
+    public:
+        shaderVariantCache() = default;
+        shaderVariantCache(shaderVariantCache&&) = delete;
+        //Getter
+        size_t Count() {
+            std::lock_guard lock(mutex);
+            return variants.size();
+        }
+        //Non-const Function
+        void FramesInFlight(uint32_t count) { framesInFlight = count; }
+        //取得特化后的管线，不存在时调用builder创建，stateKey用于区分着色器以外的管线状态（如渲染通道、顶点格式）
+        VkPipeline Get(std::span<const shaderStage> stages, const builder_t& builder, uint64_t stateKey = 0) {
+            std::vector<uint8_t> key = Key(stages, stateKey);
+            uint64_t hash = HashBytes(key.data(), key.size());
+            {
+                std::lock_guard lock(mutex);
+                if (VkPipeline handle = Find(hash, key))
+                    return handle;
+            }
+            //在锁外创建管线，其他线程取得已有的变体时不必等待
+            std::vector<VkPipelineShaderStageCreateInfo> stageCreateInfos;
+            for (auto& i : stages)
+                stageCreateInfos.push_back({
+                    .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                    .stage = i.stage,
+                    .module = i.module,
+                    .pName = i.entry,
+                    .pSpecializationInfo = i.pSpecializationInfo });
+            pipeline newPipeline;
+            if (builder(newPipeline, stageCreateInfos))
+                return VK_NULL_HANDLE;
+            std::lock_guard lock(mutex);
+            //若其他线程已抢先创建了同一变体，用已有的那个，新建的随newPipeline析构
+            if (VkPipeline handle = Find(hash, key))
+                return handle;
+            std::vector<VkShaderModule> modules;
+            for (auto& i : stages)
+                modules.push_back(i.module);
+            return variants.emplace(hash, variant{ std::move(key), std::move(modules), std::move(newPipeline) })->second.variantPipeline;
+        }
+        VkPipeline Get(const shaderStage& stage, const builder_t& builder, uint64_t stateKey = 0) {
+            return Get({ &stage, 1 }, builder, stateKey);
+        }
+        //移除用到module的变体，其管线可能仍被在途的命令缓冲区使用，过framesInFlight帧后才销毁
+        void Forget(VkShaderModule module) {
+            std::lock_guard lock(mutex);
+            for (auto iterator = variants.begin(); iterator != variants.end();)
+                if (std::ranges::find(iterator->second.modules, module) != iterator->second.modules.end())
+                    retiredPipelines.Retire(std::move(iterator->second.variantPipeline), framesInFlight),
+                    iterator = variants.erase(iterator);
+                else
+                    ++iterator;
+        }
+        //在帧边界调用，销毁足够旧的被移除的管线
+        void NextFrame() {
+            std::lock_guard lock(mutex);
+            retiredPipelines.NextFrame();
+        }
+        //管线依赖的状态失效时（如重建交换链后视口改变）清空缓存，调用前需确保管线不再被使用
+        void Clear() {
+            std::lock_guard lock(mutex);
+            variants.clear();
+        }
+    };
+}
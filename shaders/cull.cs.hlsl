@@ -0,0 +1,65 @@
+struct ObjectData
+{
+    float4x4 transform;
+    float4 boundingSphere;
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint padding;
+};
+
+struct DrawIndexedIndirectCommand
+{
+    uint indexCount;
+    uint instanceCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint firstInstance;
+};
+
+struct CullConstants
+{
+    float4 frustumPlanes[6];
+    uint objectCount;
+};
+
+[[vk::binding(0, 0)]] StructuredBuffer<ObjectData> objects;
+[[vk::binding(1, 0)]] RWStructuredBuffer<DrawIndexedIndirectCommand> drawCommands;
+[[vk::binding(2, 0)]] RWStructuredBuffer<uint> drawCount;
+[[vk::push_constant]] CullConstants constants;
+// 为true时压缩通过剔除的物体并计数，否则原位写入，被剔除的物体instanceCount为0
+[[vk::constant_id(0)]] const bool compact = true;
+
+[numthreads(64, 1, 1)]
+void main(uint3 threadId : SV_DispatchThreadID)
+{
+    uint objectIndex = threadId.x;
+    if (objectIndex >= constants.objectCount)
+        return;
+    ObjectData object = objects[objectIndex];
+    float3 center = mul(object.transform, float4(object.boundingSphere.xyz, 1.0f)).xyz;
+    float3 axisX = float3(object.transform[0][0], object.transform[1][0], object.transform[2][0]);
+    float3 axisY = float3(object.transform[0][1], object.transform[1][1], object.transform[2][1]);
+    float3 axisZ = float3(object.transform[0][2], object.transform[1][2], object.transform[2][2]);
+    float radius = object.boundingSphere.w * sqrt(max(max(dot(axisX, axisX), dot(axisY, axisY)), dot(axisZ, axisZ)));
+    bool visible = true;
+    for (uint i = 0; i < 6; i++)
+        visible = visible && dot(constants.frustumPlanes[i].xyz, center) + constants.frustumPlanes[i].w >= -radius;
+
+    DrawIndexedIndirectCommand command;
+    command.indexCount = object.indexCount;
+    command.instanceCount = visible ? 1 : 0;
+    command.firstIndex = object.firstIndex;
+    command.vertexOffset = object.vertexOffset;
+    command.firstInstance = objectIndex;
+    if (!compact)
+    {
+        drawCommands[objectIndex] = command;
+        return;
+    }
+    if (!visible)
+        return;
+    uint slot;
+    InterlockedAdd(drawCount[0], 1, slot);
+    drawCommands[slot] = command;
+}
@@ -0,0 +1,500 @@
+#pragma once
+
+#include "vkBase.h"
+
+// SPIR-V Reflection and Layout Interning
+
+namespace easyVulkan {
+    using namespace vulkan;
+
+    // 从SPIR-V字节码中提取描述符绑定、push constant范围、顶点输入、特化常量ID，多个阶段的结果可合并
+    // 只解析生成管线布局所需的那部分指令，不做完整的SPIR-V校验
+    class shaderReflection {
+    public:
+        struct descriptorBinding {
+            uint32_t set;
+            uint32_t binding;
+            VkDescriptorType type;
+            uint32_t count; //为0时对应运行时数组（即变长的描述符数组）
+            VkShaderStageFlags stageFlags;
+        };
+        struct vertexInput {
+            uint32_t location;
+            VkFormat format;
+        };
+        struct specializationConstant {
+            uint32_t constantID;
+            uint32_t size;
+        };
+    private:
+        //SPIR-V中用到的操作码和枚举值
+        enum : uint32_t {
+            opEntryPoint = 15, opExecutionMode = 16,
+            opTypeBool = 20, opTypeInt = 21, opTypeFloat = 22, opTypeVector = 23, opTypeMatrix = 24,
+            opTypeImage = 25, opTypeSampler = 26, opTypeSampledImage = 27, opTypeArray = 28, opTypeRuntimeArray = 29,
+            opTypeStruct = 30, opTypePointer = 32,
+            opConstant = 43, opSpecConstantTrue = 48, opSpecConstantFalse = 49, opSpecConstant = 50,
+            opVariable = 59, opDecorate = 71, opMemberDecorate = 72,
+            opTypeAccelerationStructure = 5341,
+
+            decorationSpecId = 1, decorationBlock = 2, decorationBufferBlock = 3, decorationArrayStride = 6, decorationMatrixStride = 7,
+            decorationBuiltIn = 11, decorationLocation = 30, decorationBinding = 33, decorationDescriptorSet = 34, decorationOffset = 35,
+
+            storageClassUniformConstant = 0, storageClassInput = 1, storageClassUniform = 2, storageClassPushConstant = 9, storageClassStorageBuffer = 12,
+
+            executionModeLocalSize = 17,
+            dimBuffer = 5, dimSubpassData = 6
+        };
+        //每个SPIR-V id对应一个spirvId，记录定义它的指令及其装饰
+        struct spirvId {
+            const uint32_t* pInstruction = nullptr;
+            uint32_t set = ~0u;
+            uint32_t binding = ~0u;
+            uint32_t location = ~0u;
+            uint32_t specId = ~0u;
+            uint32_t arrayStride = 0;
+            bool builtIn = false;
+            bool bufferBlock = false;
+            std::vector<uint32_t> memberOffsets;
+            std::vector<uint32_t> memberMatrixStrides;
+            uint32_t Opcode() const { return pInstruction ? *pInstruction & 0xffff : 0; }
+        };
+
+        static VkShaderStageFlags Stage(uint32_t executionModel) {
+            switch (executionModel) {
+            case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+            case 5313: return VK_SHADER_STAGE_RAYGEN_BIT_KHR;
+            case 5314: return VK_SHADER_STAGE_INTERSECTION_BIT_KHR;
+            case 5315: return VK_SHADER_STAGE_ANY_HIT_BIT_KHR;
+            case 5316: return VK_SHADER_STAGE_CLOSEST_HIT_BIT_KHR;
+            case 5317: return VK_SHADER_STAGE_MISS_BIT_KHR;
+            case 5318: return VK_SHADER_STAGE_CALLABLE_BIT_KHR;
+            case 5364: return VK_SHADER_STAGE_TASK_BIT_EXT;
+            case 5365: return VK_SHADER_STAGE_MESH_BIT_EXT;
+            default: return 0;
+            }
+        }
+        static VkFormat Format(uint32_t opcode, uint32_t width, bool isSigned, uint32_t componentCount) {
+            static constexpr VkFormat formats16[3][4] = {
+                { VK_FORMAT_R16_UINT, VK_FORMAT_R16G16_UINT, VK_FORMAT_R16G16B16_UINT, VK_FORMAT_R16G16B16A16_UINT },
+                { VK_FORMAT_R16_SINT, VK_FORMAT_R16G16_SINT, VK_FORMAT_R16G16B16_SINT, VK_FORMAT_R16G16B16A16_SINT },
+                { VK_FORMAT_R16_SFLOAT, VK_FORMAT_R16G16_SFLOAT, VK_FORMAT_R16G16B16_SFLOAT, VK_FORMAT_R16G16B16A16_SFLOAT } };
+            static constexpr VkFormat formats32[3][4] = {
+                { VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT },
+                { VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT },
+                { VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT } };
+            if (componentCount < 1 || componentCount > 4)
+                return VK_FORMAT_UNDEFINED;
+            size_t row = opcode == opTypeFloat ? 2 : isSigned;
+            if (width == 16)
+                return formats16[row][componentCount - 1];
+            if (width == 32)
+                return formats32[row][componentCount - 1];
+            return VK_FORMAT_UNDEFINED;
+        }
+
+        std::vector<spirvId> ids;
+
+        uint32_t ConstantValue(uint32_t id) const {
+            return ids[id].Opcode() == opConstant ? ids[id].pInstruction[3] : 0;
+        }
+        //计算类型在缓冲区中占用的字节数，用于求push constant块的大小
+        uint32_t TypeSize(uint32_t typeId, uint32_t matrixStride = 0) const {
+            const uint32_t* p = ids[typeId].pInstruction;
+            switch (ids[typeId].Opcode()) {
+            case opTypeBool:
+                return 4;
+            case opTypeInt:
+            case opTypeFloat:
+                return p[2] / 8;
+            case opTypeVector:
+                return p[3] * TypeSize(p[2]);
+            case opTypeMatrix:
+                return p[3] * (matrixStride ? matrixStride : TypeSize(p[2]));
+            case opTypeArray:
+                return ConstantValue(p[3]) * (ids[typeId].arrayStride ? ids[typeId].arrayStride : TypeSize(p[2]));
+            case opTypeStruct: {
+                auto& memberOffsets = ids[typeId].memberOffsets;
+                auto& memberMatrixStrides = ids[typeId].memberMatrixStrides;
+                uint32_t size = 0;
+                for (uint32_t i = 0; i < (p[0] >> 16) - 2; i++)
+                    size = std::max(size,
+                        (i < memberOffsets.size() ? memberOffsets[i] : 0) +
+                        TypeSize(p[2 + i], i < memberMatrixStrides.size() ? memberMatrixStrides[i] : 0));
+                return size;
+            }
+            default:
+                return 0;
+            }
+        }
+        VkDescriptorType DescriptorType(uint32_t typeId, uint32_t storageClass) const {
+            const uint32_t* p = ids[typeId].pInstruction;
+            switch (ids[typeId].Opcode()) {
+            case opTypeSampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case opTypeSampledImage:
+                return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case opTypeImage:
+                //p[3]为Dim，p[7]为Sampled，Sampled为2说明是存储图像
+                if (p[3] == dimBuffer)
+                    return p[7] == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                if (p[3] == dimSubpassData)
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                return p[7] == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+            case opTypeAccelerationStructure:
+                return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+            case opTypeStruct:
+                if (storageClass == storageClassStorageBuffer ||
+                    ids[typeId].bufferBlock)
+                    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            default:
+                return VK_DESCRIPTOR_TYPE_MAX_ENUM;
+            }
+        }
+    public:
+        VkShaderStageFlags stageFlags = 0;
+        std::vector<descriptorBinding> descriptorBindings;
+        std::vector<VkPushConstantRange> pushConstantRanges; //合并后至多一个范围，覆盖所有阶段
+        std::vector<vertexInput> vertexInputs;
+        std::vector<specializationConstant> specializationConstants;
+        uint32_t localSize[3] = {}; //计算着色器的工作组大小
+
+        shaderReflection() = default;
+        shaderReflection(std::span<const uint32_t> code) {
+            Reflect(code);
+        }
+        shaderReflection(const char* filepath) {
+            Reflect(filepath);
+        }
+        //Const Function
+        //descriptorBindings中最大的set序号+1
+        uint32_t SetCount() const {
+            uint32_t count = 0;
+            for (auto& i : descriptorBindings)
+                count = std::max(count, i.set + 1);
+            return count;
+        }
+        std::vector<VkDescriptorSetLayoutBinding> SetLayoutBindings(uint32_t set) const {
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+            for (auto& i : descriptorBindings)
+                if (i.set == set)
+                    bindings.push_back({ i.binding, i.type, i.count, i.stageFlags });
+            std::ranges::sort(bindings, {}, &VkDescriptorSetLayoutBinding::binding);
+            return bindings;
+        }
+        //按location顺序将顶点输入紧密排布在同一个绑定中，返回步长
+        uint32_t VertexInputAttributes(std::vector<VkVertexInputAttributeDescription>& attributes, uint32_t binding = 0) const {
+            std::vector<vertexInput> sortedInputs = vertexInputs;
+            std::ranges::sort(sortedInputs, {}, &vertexInput::location);
+            uint32_t offset = 0;
+            for (auto& i : sortedInputs) {
+                attributes.push_back({ i.location, binding, i.format, offset });
+                switch (i.format) {
+                case VK_FORMAT_R16_UINT: case VK_FORMAT_R16_SINT: case VK_FORMAT_R16_SFLOAT:
+                    offset += 2; break;
+                case VK_FORMAT_R32_UINT: case VK_FORMAT_R32_SINT: case VK_FORMAT_R32_SFLOAT:
+                case VK_FORMAT_R16G16_UINT: case VK_FORMAT_R16G16_SINT: case VK_FORMAT_R16G16_SFLOAT:
+                    offset += 4; break;
+                case VK_FORMAT_R16G16B16_UINT: case VK_FORMAT_R16G16B16_SINT: case VK_FORMAT_R16G16B16_SFLOAT:
+                    offset += 6; break;
+                case VK_FORMAT_R32G32_UINT: case VK_FORMAT_R32G32_SINT: case VK_FORMAT_R32G32_SFLOAT:
+                case VK_FORMAT_R16G16B16A16_UINT: case VK_FORMAT_R16G16B16A16_SINT: case VK_FORMAT_R16G16B16A16_SFLOAT:
+                    offset += 8; break;
+                case VK_FORMAT_R32G32B32_UINT: case VK_FORMAT_R32G32B32_SINT: case VK_FORMAT_R32G32B32_SFLOAT:
+                    offset += 12; break;
+                default:
+                    offset += 16;
+                }
+            }
+            return offset;
+        }
+        //Non-const Function
+        result_t Reflect(const char* filepath) {
+            std::vector<uint32_t> code;
+            if (VkResult result = shaderModule::ReadCode(filepath, code))
+                return result;
+            return Reflect(code);
+        }
+        result_t Reflect(std::span<const uint32_t> code) {
+            *this = {};
+            if (code.size() < 5 || code[0] != 0x07230203) {
+                outStream << std::format("[ shaderReflection ] ERROR\nInvalid SPIR-V binary!\n");
+                return VK_RESULT_MAX_ENUM;
+            }
+            ids.resize(code[3]); //code[3]为id的上界
+            auto Id = [&](uint32_t id) -> spirvId* { return id < ids.size() ? &ids[id] : nullptr; };
+            //第二遍及各辅助函数按下标读取所记录的指令，其操作数个数须足够，引用的id须在上界之内
+            auto ValidOperands = [&](const uint32_t* p, uint32_t wordCount) {
+                auto InRange = [&](uint32_t id) { return id < ids.size(); };
+                switch (p[0] & 0xffff) {
+                case opTypeInt: return wordCount >= 4;
+                case opTypeFloat: return wordCount >= 3;
+                case opTypeVector: case opTypeMatrix: return wordCount >= 4 && InRange(p[2]);
+                case opTypeImage: return wordCount >= 9 && InRange(p[2]);
+                case opTypeSampledImage: case opTypeRuntimeArray: return wordCount >= 3 && InRange(p[2]);
+                case opTypeArray: return wordCount >= 4 && InRange(p[2]) && InRange(p[3]);
+                case opTypeStruct: return std::all_of(p + 2, p + wordCount, InRange);
+                case opTypePointer: return wordCount >= 4 && InRange(p[3]);
+                case opConstant: case opSpecConstant: case opVariable: return wordCount >= 4 && InRange(p[1]);
+                case opSpecConstantTrue: case opSpecConstantFalse: return wordCount >= 3 && InRange(p[1]);
+                default: return true;
+                }
+            };
+            //第一遍：记录类型、常量、变量的定义及所有装饰
+            for (size_t i = 5; i < code.size();) {
+                const uint32_t* p = &code[i];
+                uint32_t wordCount = p[0] >> 16;
+                if (!wordCount || i + wordCount > code.size()) {
+                    outStream << std::format("[ shaderReflection ] ERROR\nCorrupted SPIR-V instruction at word {}!\n", i);
+                    ids.clear();
+                    return VK_RESULT_MAX_ENUM;
+                }
+                size_t instructionOffset = i;
+                i += wordCount;
+                spirvId* pId = nullptr;
+                bool defined = false; //是定义类型、常量、变量的指令
+                switch (p[0] & 0xffff) {
+                case opEntryPoint:
+                    if (wordCount >= 2)
+                        stageFlags |= Stage(p[1]);
+                    break;
+                case opExecutionMode:
+                    if (wordCount >= 6 && p[2] == executionModeLocalSize)
+                        localSize[0] = p[3], localSize[1] = p[4], localSize[2] = p[5];
+                    break;
+                case opDecorate:
+                    if (!(pId = Id(p[1])) || wordCount < 3)
+                        break;
+                    if (p[2] != decorationBlock && p[2] != decorationBufferBlock && wordCount < 4)
+                        break;
+                    switch (p[2]) {
+                    case decorationSpecId: pId->specId = p[3]; break;
+                    case decorationBufferBlock: pId->bufferBlock = true; break;
+                    case decorationArrayStride: pId->arrayStride = p[3]; break;
+                    case decorationBuiltIn: pId->builtIn = true; break;
+                    case decorationLocation: pId->location = p[3]; break;
+                    case decorationBinding: pId->binding = p[3]; break;
+                    case decorationDescriptorSet: pId->set = p[3]; break;
+                    }
+                    break;
+                case opMemberDecorate:
+                    if (!(pId = Id(p[1])) || wordCount < 5)
+                        break;
+                    if (p[3] == decorationOffset)
+                        pId->memberOffsets.resize(std::max<size_t>(pId->memberOffsets.size(), p[2] + 1)),
+                        pId->memberOffsets[p[2]] = p[4];
+                    else if (p[3] == decorationMatrixStride)
+                        pId->memberMatrixStrides.resize(std::max<size_t>(pId->memberMatrixStrides.size(), p[2] + 1)),
+                        pId->memberMatrixStrides[p[2]] = p[4];
+                    break;
+                case opTypeBool: case opTypeInt: case opTypeFloat: case opTypeVector: case opTypeMatrix:
+                case opTypeImage: case opTypeSampler: case opTypeSampledImage: case opTypeArray: case opTypeRuntimeArray:
+                case opTypeStruct: case opTypePointer: case opTypeAccelerationStructure:
+                    pId = wordCount >= 2 ? Id(p[1]) : nullptr;
+                    defined = true;
+                    break;
+                case opConstant: case opSpecConstantTrue: case opSpecConstantFalse: case opSpecConstant: case opVariable:
+                    pId = wordCount >= 3 ? Id(p[2]) : nullptr;
+                    defined = true;
+                    break;
+                }
+                if (!defined)
+                    continue;
+                if (!pId || !ValidOperands(p, wordCount)) {
+                    outStream << std::format("[ shaderReflection ] ERROR\nInvalid id or operand count in the SPIR-V instruction at word {}!\n", instructionOffset);
+                    ids.clear();
+                    return VK_RESULT_MAX_ENUM;
+                }
+                pId->pInstruction = p;
+            }
+            //第二遍：由变量和特化常量得到反射结果
+            for (auto& i : ids) {
+                const uint32_t* p = i.pInstruction;
+                switch (i.Opcode()) {
+                case opSpecConstantTrue:
+                case opSpecConstantFalse:
+                case opSpecConstant:
+                    if (i.specId != ~0u)
+                        specializationConstants.push_back({ i.specId, TypeSize(p[1]) });
+                    break;
+                case opVariable: {
+                    uint32_t storageClass = p[3];
+                    if (ids[p[1]].Opcode() != opTypePointer)
+                        break;
+                    uint32_t typeId = ids[p[1]].pInstruction[3];
+                    if (storageClass == storageClassPushConstant) {
+                        if (uint32_t size = TypeSize(typeId))
+                            pushConstantRanges.push_back({ stageFlags, 0, size });
+                    }
+                    else if (storageClass == storageClassInput) {
+                        if (!(stageFlags & VK_SHADER_STAGE_VERTEX_BIT) || i.builtIn || i.location == ~0u)
+                            break;
+                        const uint32_t* pType = ids[typeId].pInstruction;
+                        uint32_t componentCount = 1;
+                        if (ids[typeId].Opcode() == opTypeVector)
+                            componentCount = pType[3],
+                            pType = ids[pType[2]].pInstruction;
+                        if (!pType)
+                            break;
+                        uint32_t opcode = pType[0] & 0xffff;
+                        if (opcode != opTypeInt && opcode != opTypeFloat)
+                            break;
+                        vertexInputs.push_back({ i.location, Format(opcode, pType[2], opcode == opTypeInt && pType[3], componentCount) });
+                    }
+                    else if (storageClass == storageClassUniformConstant ||
+                        storageClass == storageClassUniform ||
+                        storageClass == storageClassStorageBuffer) {
+                        if (i.binding == ~0u)
+                            break;
+                        //剥去数组，数组长度即描述符个数
+                        uint32_t count = 1;
+                        while (ids[typeId].Opcode() == opTypeArray || ids[typeId].Opcode() == opTypeRuntimeArray) {
+                            const uint32_t* pArray = ids[typeId].pInstruction;
+                            count = ids[typeId].Opcode() == opTypeArray ? count * ConstantValue(pArray[3]) : 0;
+                            typeId = pArray[2];
+                        }
+                        VkDescriptorType type = DescriptorType(typeId, storageClass);
+                        if (type != VK_DESCRIPTOR_TYPE_MAX_ENUM)
+                            descriptorBindings.push_back({ i.set == ~0u ? 0 : i.set, i.binding, type, count, stageFlags });
+                    }
+                    break;
+                }
+                }
+            }
+            ids.clear();
+            return VK_SUCCESS;
+        }
+        //合并另一阶段的反射结果，同一set和binding的描述符类型不一致时返回错误
+        result_t Merge(const shaderReflection& other) {
+            for (auto& i : other.descriptorBindings) {
+                auto iterator = std::ranges::find_if(descriptorBindings, [&](const descriptorBinding& binding) {
+                    return binding.set == i.set && binding.binding == i.binding; });
+                if (iterator == descriptorBindings.end()) {
+                    descriptorBindings.push_back(i);
+                    continue;
+                }
+                if (iterator->type != i.type) {
+                    outStream << std::format("[ shaderReflection ] ERROR\nConflicting descriptor types at set {} binding {}!\n", i.set, i.binding);
+                    return VK_RESULT_MAX_ENUM;
+                }
+                iterator->stageFlags |= i.stageFlags;
+                iterator->count = iterator->count && i.count ? std::max(iterator->count, i.count) : 0;
+            }
+            //push constant合并为一个覆盖所有阶段的范围
+            for (auto& i : other.pushConstantRanges)
+                if (pushConstantRanges.empty())
+                    pushConstantRanges.push_back(i);
+                else {
+                    auto& range = pushConstantRanges[0];
+                    uint32_t end = std::max(range.offset + range.size, i.offset + i.size);
+                    range.offset = std::min(range.offset, i.offset);
+                    range.size = end - range.offset;
+                    range.stageFlags |= i.stageFlags;
+                }
+            if (pushConstantRanges.size())
+                pushConstantRanges[0].stageFlags |= stageFlags | other.stageFlags;
+            for (auto& i : other.specializationConstants)
+                if (std::ranges::find(specializationConstants, i.constantID, &specializationConstant::constantID) == specializationConstants.end())
+                    specializationConstants.push_back(i);
+            vertexInputs.insert(vertexInputs.end(), other.vertexInputs.begin(), other.vertexInputs.end());
+            for (size_t i = 0; i < 3; i++)
+                localSize[i] = std::max(localSize[i], other.localSize[i]);
+            stageFlags |= other.stageFlags;
+            return VK_SUCCESS;
+        }
+    };
+
+    // 按内容驻留（intern）描述符集布局和管线布局，内容相同的布局只创建一次，布局兼容的管线可共用描述符集
+    class layoutCache {
+        struct setLayoutEntry {
+            std::vector<VkDescriptorSetLayoutBinding> bindings; //不可变采样器按指针比较，其生命周期由调用者保证
+            VkDescriptorSetLayoutCreateFlags flags;
+            descriptorSetLayout layout;
+        };
+        struct pipelineLayoutEntry {
+            std::vector<VkDescriptorSetLayout> setLayouts;
+            std::vector<VkPushConstantRange> pushConstantRanges;
+            pipelineLayout layout;
+        };
+        std::mutex mutex;
+        std::unordered_multimap<uint64_t, setLayoutEntry> setLayouts;
+        std::unordered_multimap<uint64_t, pipelineLayoutEntry> pipelineLayouts;
+
+        static bool Equal(const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+            return a.binding == b.binding &&
+                a.descriptorType == b.descriptorType &&
+                a.descriptorCount == b.descriptorCount &&
+                a.stageFlags == b.stageFlags &&
+                a.pImmutableSamplers == b.pImmutableSamplers;
+        }
+        static bool Equal(const VkPushConstantRange& a, const VkPushConstantRange& b) {
+            return a.stageFlags == b.stageFlags && a.offset == b.offset && a.size == b.size;
+        }
+    public:
+        layoutCache() = default;
+        layoutCache(layoutCache&&) = delete;
+        //Non-const Function
+        //bindings需按binding排序，同一内容的布局只创建一次
+        VkDescriptorSetLayout DescriptorSetLayout(std::span<const VkDescriptorSetLayoutBinding> bindings, VkDescriptorSetLayoutCreateFlags flags = 0) {
+            uint64_t hash = HashObject(flags);
+            for (auto& i : bindings)
+                hash = HashObject(i, hash);
+            std::lock_guard lock(mutex);
+            auto [begin, end] = setLayouts.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (iterator->second.flags == flags &&
+                    std::ranges::equal(iterator->second.bindings, bindings, [](auto& a, auto& b) { return Equal(a, b); }))
+                    return iterator->second.layout;
+            VkDescriptorSetLayoutCreateInfo createInfo = {
+                .flags = flags,
+                .bindingCount = uint32_t(bindings.size()),
+                .pBindings = bindings.data()
+            };
+            descriptorSetLayout layout;
+            if (layout.Create(createInfo))
+                return VK_NULL_HANDLE;
+            return setLayouts.emplace(hash, setLayoutEntry{ { bindings.begin(), bindings.end() }, flags, std::move(layout) })->second.layout;
+        }
+        VkPipelineLayout PipelineLayout(std::span<const VkDescriptorSetLayout> setLayouts, std::span<const VkPushConstantRange> pushConstantRanges = {}) {
+            uint64_t hash = HashBytes(setLayouts.data(), setLayouts.size_bytes());
+            hash = HashBytes(pushConstantRanges.data(), pushConstantRanges.size_bytes(), hash);
+            std::lock_guard lock(mutex);
+            auto [begin, end] = pipelineLayouts.equal_range(hash);
+            for (auto iterator = begin; iterator != end; ++iterator)
+                if (std::ranges::equal(iterator->second.setLayouts, setLayouts) &&
+                    std::ranges::equal(iterator->second.pushConstantRanges, pushConstantRanges, [](auto& a, auto& b) { return Equal(a, b); }))
+                    return iterator->second.layout;
+            VkPipelineLayoutCreateInfo createInfo = {
+                .setLayoutCount = uint32_t(setLayouts.size()),
+                .pSetLayouts = setLayouts.data(),
+                .pushConstantRangeCount = uint32_t(pushConstantRanges.size()),
+                .pPushConstantRanges = pushConstantRanges.data()
+            };
+            pipelineLayout layout;
+            if (layout.Create(createInfo))
+                return VK_NULL_HANDLE;
+            return pipelineLayouts.emplace(hash, pipelineLayoutEntry{
+                { setLayouts.begin(), setLayouts.end() },
+                { pushConstantRanges.begin(), pushConstantRanges.end() },
+                std::move(layout) })->second.layout;
+        }
+        //由（合并后的）反射结果生成管线布局，未被使用的set序号对应空的描述符集布局
+        VkPipelineLayout PipelineLayout(const shaderReflection& reflection) {
+            std::vector<VkDescriptorSetLayout> setLayouts(reflection.SetCount());
+            for (uint32_t i = 0; i < setLayouts.size(); i++)
+                if (!(setLayouts[i] = DescriptorSetLayout(reflection.SetLayoutBindings(i))))
+                    return VK_NULL_HANDLE;
+            return PipelineLayout(setLayouts, reflection.pushConstantRanges);
+        }
+        //用于获取反射结果中某个set的描述符集布局（比如分配描述符集时）
+        VkDescriptorSetLayout DescriptorSetLayout(const shaderReflection& reflection, uint32_t set) {
+            return DescriptorSetLayout(reflection.SetLayoutBindings(set));
+        }
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "vkStart.h"
+
+// Thread Pool
+
+namespace easyVulkan {
+    // 后台编译管线、并行录制命令等用的线程池，任务按提交顺序执行
+    class threadPool {
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool stopping = false;
+
+        void Work() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(mutex);
+                    condition.wait(lock, [this] { return stopping || tasks.size(); });
+                    //析构时先做完剩下的任务再退出
+                    if (tasks.empty())
+                        return;
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+    public:
+        //默认留一个硬件线程给渲染线程
+        threadPool(uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1) {
+            for (uint32_t i = 0; i < threadCount; i++)
+                workers.emplace_back([this] { Work(); });
+        }
+        threadPool(threadPool&&) = delete;
+        ~threadPool() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            condition.notify_all();
+            for (auto& i : workers)
+                i.join();
+        }
+        //Getter
+        uint32_t ThreadCount() const { return uint32_t(workers.size()); }
+        //Non-const Function
+        //提交一个任务，返回可用于等待其结果的future
+        template<typename F>
+        auto Submit(F&& function) -> std::future<std::invoke_result_t<F>> {
+            auto pTask = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(function));
+            auto future = pTask->get_future();
+            {
+                std::lock_guard lock(mutex);
+                tasks.emplace_back([pTask] { (*pTask)(); });
+            }
+            condition.notify_one();
+            return future;
+        }
+    };
+}
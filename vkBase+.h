@@ -2,6 +2,50 @@
 
 #include "vkBase.h"
 
+// graphicsPipelineCreateInfoPackfixedGraphicsPipelineCreateInfoPack
+// úڽpackиĵַ͸ֵӦĴϢ
+template<typename pack_t>
+constexpr void UpdatePipelineCreateInfoArrays(pack_t& pack) {
+    pack.createInfo.stageCount = pack.shaderStages.size();
+    pack.createInfo.pStages = pack.shaderStages.data();
+    pack.vertexInputStateCi.vertexBindingDescriptionCount = pack.vertexInputBindings.size();
+    pack.vertexInputStateCi.pVertexBindingDescriptions = pack.vertexInputBindings.data();
+    pack.vertexInputStateCi.vertexAttributeDescriptionCount = pack.vertexInputAttributes.size();
+    pack.vertexInputStateCi.pVertexAttributeDescriptions = pack.vertexInputAttributes.data();
+    pack.viewportStateCi.viewportCount = pack.viewports.size() ? uint32_t(pack.viewports.size()) : pack.dynamicViewportCount;
+    pack.viewportStateCi.pViewports = pack.viewports.data();
+    pack.viewportStateCi.scissorCount = pack.scissors.size() ? uint32_t(pack.scissors.size()) : pack.dynamicScissorCount;
+    pack.viewportStateCi.pScissors = pack.scissors.data();
+    pack.colorBlendStateCi.attachmentCount = pack.colorBlendAttachmentStates.size();
+    pack.colorBlendStateCi.pAttachments = pack.colorBlendAttachmentStates.data();
+    pack.dynamicStateCi.dynamicStateCount = pack.dynamicStates.size();
+    pack.dynamicStateCi.pDynamicStates = pack.dynamicStates.data();
+    pack.renderingCi.colorAttachmentCount = pack.colorAttachmentFormats.size();
+    pack.renderingCi.pColorAttachmentFormats = pack.colorAttachmentFormats.data();
+}
+// úڽpack.createInfopartsָĲдpack.libraryPartCreateInfographicsPipelineCreateInfoPack::LibraryCreateInfo(...)
+template<typename pack_t>
+constexpr VkGraphicsPipelineCreateInfo& PipelineLibraryCreateInfo(pack_t& pack, VkGraphicsPipelineLibraryFlagsEXT parts, bool retainLinkTimeOptimizationInfo) {
+    const VkGraphicsPipelineCreateInfo& createInfo = pack.createInfo;
+    pack.libraryShaderStages.clear();
+    for (uint32_t i = 0; i < createInfo.stageCount; i++) {
+        bool isFragmentStage = createInfo.pStages[i].stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+        if ((isFragmentStage && parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT) ||
+            (!isFragmentStage && parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT))
+            pack.libraryShaderStages.push_back(createInfo.pStages[i]);
+    }
+    pack.libraryCi.pNext = createInfo.pNext;
+    pack.libraryCi.flags = parts;
+    pack.libraryPartCreateInfo = createInfo;
+    pack.libraryPartCreateInfo.pNext = &pack.libraryCi;
+    pack.libraryPartCreateInfo.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+    if (retainLinkTimeOptimizationInfo)
+        pack.libraryPartCreateInfo.flags |= VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    pack.libraryPartCreateInfo.stageCount = uint32_t(pack.libraryShaderStages.size());
+    pack.libraryPartCreateInfo.pStages = pack.libraryShaderStages.data();
+    return pack.libraryPartCreateInfo;
+}
+
 // graphicsPipelineCreateInfoĳװ
 // дϢṹ嶼ûй캯ľۺ壬ųʼбδἰĳԱʼ
 struct graphicsPipelineCreateInfoPack {
@@ -45,6 +89,15 @@ struct graphicsPipelineCreateInfoPack {
     VkPipelineDynamicStateCreateInfo dynamicStateCi =
     { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
     std::vector<VkDynamicState> dynamicStates;
+    //Graphics Pipeline LibraryLibraryCreateInfo(...)д渴ƹ
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryCi =
+    { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT };
+    VkGraphicsPipelineCreateInfo libraryPartCreateInfo = {};
+    std::vector<VkPipelineShaderStageCreateInfo> libraryShaderStages;
+    //Dynamic RenderingUseDynamicRendering(...)createInfo.pNext
+    VkPipelineRenderingCreateInfo renderingCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
+    std::vector<VkFormat> colorAttachmentFormats;
 
     //--------------------
 
@@ -57,6 +110,10 @@ struct graphicsPipelineCreateInfoPack {
     graphicsPipelineCreateInfoPack(const graphicsPipelineCreateInfoPack& other) noexcept {
         createInfo = other.createInfo;
         SetCreateInfos();
+        renderingCi = other.renderingCi;
+        colorAttachmentFormats = other.colorAttachmentFormats;
+        if (other.createInfo.pNext == &other.renderingCi)
+            createInfo.pNext = &renderingCi;
 
         vertexInputStateCi = other.vertexInputStateCi;
         inputAssemblyStateCi = other.inputAssemblyStateCi;
@@ -79,17 +136,27 @@ struct graphicsPipelineCreateInfoPack {
     }
     //Getterûconstη
     operator VkGraphicsPipelineCreateInfo& () { return createInfo; }
+    //úVK_EXT_graphics_pipeline_libraryֻpartsֵָĴϢԴ߿
+    //롢դǰɫƬɫƬĲֿɷֱ룬֮pipeline::Link(...)ӳ
+    //ɫ׶λᱻɸѡΪpartsЩص´εøúǰЧǰȵUpdateAllArrays()
+    VkGraphicsPipelineCreateInfo& LibraryCreateInfo(VkGraphicsPipelineLibraryFlagsEXT parts, bool retainLinkTimeOptimizationInfo = true) {
+        return PipelineLibraryCreateInfo(*this, parts, retainLinkTimeOptimizationInfo);
+    }
     //Non-const Function
+    //ʹڶ̬ȾָȾͨʽ뿪ʼȾʱõimage viewһ
+    void UseDynamicRendering(vulkan::arrayRef<const VkFormat> colorFormats, VkFormat depthFormat = VK_FORMAT_UNDEFINED, VkFormat stencilFormat = VK_FORMAT_UNDEFINED, uint32_t viewMask = 0) {
+        colorAttachmentFormats.assign(colorFormats.begin(), colorFormats.end());
+        renderingCi.viewMask = viewMask;
+        renderingCi.depthAttachmentFormat = depthFormat;
+        renderingCi.stencilAttachmentFormat = stencilFormat;
+        if (createInfo.pNext != &renderingCi)
+            renderingCi.pNext = createInfo.pNext,
+            createInfo.pNext = &renderingCi;
+        createInfo.renderPass = VK_NULL_HANDLE;
+    }
     //úڽvectorݵĵֵַϢӦԱӦıcount
     void UpdateAllArrays() {
-        createInfo.stageCount = shaderStages.size();
-        vertexInputStateCi.vertexBindingDescriptionCount = vertexInputBindings.size();
-        vertexInputStateCi.vertexAttributeDescriptionCount = vertexInputAttributes.size();
-        viewportStateCi.viewportCount = viewports.size() ? uint32_t(viewports.size()) : dynamicViewportCount;
-        viewportStateCi.scissorCount = scissors.size() ? uint32_t(scissors.size()) : dynamicScissorCount;
-        colorBlendStateCi.attachmentCount = colorBlendAttachmentStates.size();
-        dynamicStateCi.dynamicStateCount = dynamicStates.size();
-        UpdateAllArrayAddresses();
+        UpdatePipelineCreateInfoArrays(*this);
     }
 private:
     //úڽϢĵֵַbasePipelineIndexӦԱ
@@ -114,5 +181,267 @@ private:
         viewportStateCi.pScissors = scissors.data();
         colorBlendStateCi.pAttachments = colorBlendAttachmentStates.data();
         dynamicStateCi.pDynamicStates = dynamicStates.data();
+        renderingCi.pColorAttachmentFormats = colorAttachmentFormats.data();
+    }
+};
+
+// graphicsPipelineCreateInfoPackĶ汾ΪڵfixedVector졢ƾڴ
+// ָָֻڵUpdateAllArrays()ʱдƽƣҲڱڹΪԤ
+// ɹ߱ʱһԤٸĶ״̬ȻUpdateAllArrays()
+struct fixedGraphicsPipelineCreateInfoPack {
+    VkGraphicsPipelineCreateInfo createInfo =
+    { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
+
+    //===== shader stage =======
+    vulkan::fixedVector<VkPipelineShaderStageCreateInfo, 6> shaderStages;
+    //Vertex Input
+    VkPipelineVertexInputStateCreateInfo vertexInputStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vulkan::fixedVector<VkVertexInputBindingDescription, 8> vertexInputBindings;
+    vulkan::fixedVector<VkVertexInputAttributeDescription, 16> vertexInputAttributes;
+    //Input Assembly
+    VkPipelineInputAssemblyStateCreateInfo inputAssemblyStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO };
+    //Tessellation
+    VkPipelineTessellationStateCreateInfo tessellationStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_TESSELLATION_STATE_CREATE_INFO };
+    //Viewport
+    VkPipelineViewportStateCreateInfo viewportStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO };
+    vulkan::fixedVector<VkViewport, 4> viewports;
+    vulkan::fixedVector<VkRect2D, 4> scissors;
+    uint32_t dynamicViewportCount = 1;
+    uint32_t dynamicScissorCount = 1;
+    //Rasterization
+    VkPipelineRasterizationStateCreateInfo rasterizationStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO };
+    //Multisample
+    VkPipelineMultisampleStateCreateInfo multisampleStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO };
+    //Depth & Stencil
+    VkPipelineDepthStencilStateCreateInfo depthStencilStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO };
+    //Color Blend
+    VkPipelineColorBlendStateCreateInfo colorBlendStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO };
+    vulkan::fixedVector<VkPipelineColorBlendAttachmentState, 8> colorBlendAttachmentStates;
+    //Dynamic
+    VkPipelineDynamicStateCreateInfo dynamicStateCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+    vulkan::fixedVector<VkDynamicState, 32> dynamicStates;
+    //Dynamic RenderingrenderingCi.pNextUseDynamicRendering(...)ʱcreateInfo.pNextԭе
+    VkPipelineRenderingCreateInfo renderingCi =
+    { VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO };
+    vulkan::fixedVector<VkFormat, 8> colorAttachmentFormats;
+    bool dynamicRendering = false;
+    //Graphics Pipeline LibraryLibraryCreateInfo(...)д
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryCi =
+    { VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT };
+    VkGraphicsPipelineCreateInfo libraryPartCreateInfo = {};
+    vulkan::fixedVector<VkPipelineShaderStageCreateInfo, 6> libraryShaderStages;
+
+    //--------------------
+
+    constexpr fixedGraphicsPipelineCreateInfoPack() {
+        createInfo.basePipelineIndex = -1;
+    }
+    //GettergraphicsPipelineCreateInfoPackͬĶcreateInfoƺȵUpdateAllArrays()
+    operator VkGraphicsPipelineCreateInfo& () { return createInfo; }
+    //ͬgraphicsPipelineCreateInfoPack::LibraryCreateInfo(...)
+    VkGraphicsPipelineCreateInfo& LibraryCreateInfo(VkGraphicsPipelineLibraryFlagsEXT parts, bool retainLinkTimeOptimizationInfo = true) {
+        return PipelineLibraryCreateInfo(*this, parts, retainLinkTimeOptimizationInfo);
     }
-};
\ No newline at end of file
+    //Non-const Function
+    void UseDynamicRendering(vulkan::arrayRef<const VkFormat> colorFormats, VkFormat depthFormat = VK_FORMAT_UNDEFINED, VkFormat stencilFormat = VK_FORMAT_UNDEFINED, uint32_t viewMask = 0) {
+        colorAttachmentFormats.assign(colorFormats.begin(), colorFormats.end());
+        renderingCi.viewMask = viewMask;
+        renderingCi.depthAttachmentFormat = depthFormat;
+        renderingCi.stencilAttachmentFormat = stencilFormat;
+        if (!dynamicRendering)
+            renderingCi.pNext = createInfo.pNext;
+        createInfo.renderPass = VK_NULL_HANDLE;
+        dynamicRendering = true;
+    }
+    //úڽϢĵַ͸ֵӦԱƻĶ󡢴ǰ
+    constexpr void UpdateAllArrays() {
+        createInfo.pVertexInputState = &vertexInputStateCi;
+        createInfo.pInputAssemblyState = &inputAssemblyStateCi;
+        createInfo.pTessellationState = &tessellationStateCi;
+        createInfo.pViewportState = &viewportStateCi;
+        createInfo.pRasterizationState = &rasterizationStateCi;
+        createInfo.pMultisampleState = &multisampleStateCi;
+        createInfo.pDepthStencilState = &depthStencilStateCi;
+        createInfo.pColorBlendState = &colorBlendStateCi;
+        createInfo.pDynamicState = &dynamicStateCi;
+        UpdatePipelineCreateInfoArrays(*this);
+        if (dynamicRendering)
+            createInfo.pNext = &renderingCi;
+    }
+};
+static_assert(std::is_trivially_copyable_v<fixedGraphicsPipelineCreateInfoPack>);
+
+// computePipelineCreateInfoİװ¹Сʱ߳ȡΪ
+// ָָ룬ֱӸ
+struct computePipelineCreateInfoPack {
+    VkComputePipelineCreateInfo createInfo =
+    { VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    uint32_t localSize[3] = { 1, 1, 1 };
+
+    //--------------------
+
+    computePipelineCreateInfoPack() {
+        createInfo.basePipelineIndex = -1;
+    }
+    computePipelineCreateInfoPack(const VkPipelineShaderStageCreateInfo& stage, VkPipelineLayout layout, uint32_t localSizeX, uint32_t localSizeY = 1, uint32_t localSizeZ = 1) :computePipelineCreateInfoPack() {
+        createInfo.stage = stage;
+        createInfo.layout = layout;
+        localSize[0] = localSizeX;
+        localSize[1] = localSizeY;
+        localSize[2] = localSizeZ;
+    }
+    //Getter
+    operator VkComputePipelineCreateInfo& () { return createInfo; }
+};
+
+namespace vulkan {
+    // ṹTӳΪVkSpecializationInfoӳĿڱ
+    // TĳԱζӦconstantIDsеIDδָconstantIDsʱΪ012...
+    // TĳԱΪ4ֽڵıuint32_tint32_tfloatVkBool32boolдVkBool32
+    template<typename T, uint32_t... constantIDs>
+    class specializationInfo {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_standard_layout_v<T>);
+        static_assert(sizeof(T) % 4 == 0, "Members of a specialization constant struct must be 4-byte scalars.");
+        static constexpr uint32_t constantCount = sizeof(T) / 4;
+        static_assert(sizeof...(constantIDs) == 0 || sizeof...(constantIDs) == constantCount);
+        static constexpr std::array<VkSpecializationMapEntry, constantCount> mapEntries = [] {
+            constexpr uint32_t ids[] = { constantIDs..., 0 };
+            std::array<VkSpecializationMapEntry, constantCount> mapEntries = {};
+            for (uint32_t i = 0; i < constantCount; i++)
+                mapEntries[i] = { sizeof...(constantIDs) ? ids[i] : i, i * 4, 4 };
+            return mapEntries;
+        }();
+        VkSpecializationInfo info = { constantCount, mapEntries.data(), sizeof(T), &data };
+    public:
+        T data = {};
+        specializationInfo() = default;
+        specializationInfo(const T& data) :data(data) {}
+        specializationInfo(const specializationInfo& other) :data(other.data) {}
+        specializationInfo& operator=(const specializationInfo& other) {
+            data = other.data;
+            return *this;
+        }
+        //Getter
+        const VkSpecializationInfo* Address() const { return &info; }
+        operator const VkSpecializationInfo* () const { return &info; }
+    };
+
+    // ùߣshaderObjectʱ״̬ãýṹ屣Щ״̬CmdSetAll(...)һ
+    // ĬֵgraphicsPipelineCreateInfoPackʼĽб޳/ģԡɫ
+    struct shaderObjectStatePack {
+        //Vertex Input
+        std::vector<VkVertexInputBindingDescription2EXT> vertexInputBindings;
+        std::vector<VkVertexInputAttributeDescription2EXT> vertexInputAttributes;
+        //Input Assembly
+        VkPrimitiveTopology primitiveTopology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+        VkBool32 primitiveRestartEnable = false;
+        //Viewport
+        std::vector<VkViewport> viewports;
+        std::vector<VkRect2D> scissors;
+        //Rasterization
+        VkBool32 depthClampEnable = false;
+        VkBool32 rasterizerDiscardEnable = false;
+        VkPolygonMode polygonMode = VK_POLYGON_MODE_FILL;
+        VkCullModeFlags cullMode = VK_CULL_MODE_NONE;
+        VkFrontFace frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        VkBool32 depthBiasEnable = false;
+        float depthBiasConstantFactor = 0;
+        float depthBiasClamp = 0;
+        float depthBiasSlopeFactor = 0;
+        float lineWidth = 1;
+        //Multisample
+        VkSampleCountFlagBits rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        VkSampleMask sampleMask = ~0u;
+        VkBool32 alphaToCoverageEnable = false;
+        VkBool32 alphaToOneEnable = false;
+        //Depth & Stencil
+        VkBool32 depthTestEnable = false;
+        VkBool32 depthWriteEnable = false;
+        VkCompareOp depthCompareOp = VK_COMPARE_OP_LESS;
+        VkBool32 depthBoundsTestEnable = false;
+        float minDepthBounds = 0;
+        float maxDepthBounds = 1;
+        VkBool32 stencilTestEnable = false;
+        VkStencilOpState front = {};
+        VkStencilOpState back = {};
+        //Color BlendvectorԪظɫһ
+        VkBool32 logicOpEnable = false;
+        VkLogicOp logicOp = VK_LOGIC_OP_COPY;
+        float blendConstants[4] = {};
+        std::vector<VkBool32> colorBlendEnables;
+        std::vector<VkColorBlendEquationEXT> colorBlendEquations;
+        std::vector<VkColorComponentFlags> colorWriteMasks;
+
+        //--------------------
+
+        //ɫдRGBAɫ
+        void AddColorAttachment(VkBool32 blendEnable = false, const VkColorBlendEquationEXT& equation = {}) {
+            colorBlendEnables.push_back(blendEnable);
+            colorBlendEquations.push_back(equation);
+            colorWriteMasks.push_back(0b1111);
+        }
+        //Const Function
+        void CmdSetAll(VkCommandBuffer commandBuffer) const {
+            auto& functions = shaderObject::Functions();
+            auto& features = graphicsBase::Base().PhysicalDeviceFeatures();
+            functions.vkCmdSetVertexInputEXT(commandBuffer,
+                uint32_t(vertexInputBindings.size()), vertexInputBindings.data(),
+                uint32_t(vertexInputAttributes.size()), vertexInputAttributes.data());
+            vkCmdSetPrimitiveTopology(commandBuffer, primitiveTopology);
+            vkCmdSetPrimitiveRestartEnable(commandBuffer, primitiveRestartEnable);
+            vkCmdSetViewportWithCount(commandBuffer, uint32_t(viewports.size()), viewports.data());
+            vkCmdSetScissorWithCount(commandBuffer, uint32_t(scissors.size()), scissors.data());
+            vkCmdSetRasterizerDiscardEnable(commandBuffer, rasterizerDiscardEnable);
+            functions.vkCmdSetPolygonModeEXT(commandBuffer, polygonMode);
+            vkCmdSetCullMode(commandBuffer, cullMode);
+            vkCmdSetFrontFace(commandBuffer, frontFace);
+            vkCmdSetDepthBiasEnable(commandBuffer, depthBiasEnable);
+            if (depthBiasEnable)
+                vkCmdSetDepthBias(commandBuffer, depthBiasConstantFactor, depthBiasClamp, depthBiasSlopeFactor);
+            vkCmdSetLineWidth(commandBuffer, lineWidth);
+            functions.vkCmdSetRasterizationSamplesEXT(commandBuffer, rasterizationSamples);
+            functions.vkCmdSetSampleMaskEXT(commandBuffer, rasterizationSamples, &sampleMask);
+            functions.vkCmdSetAlphaToCoverageEnableEXT(commandBuffer, alphaToCoverageEnable);
+            vkCmdSetDepthTestEnable(commandBuffer, depthTestEnable);
+            vkCmdSetDepthWriteEnable(commandBuffer, depthWriteEnable);
+            vkCmdSetDepthCompareOp(commandBuffer, depthCompareOp);
+            vkCmdSetStencilTestEnable(commandBuffer, stencilTestEnable);
+            if (stencilTestEnable)
+                for (auto [faceMask, state] : { std::pair{ VK_STENCIL_FACE_FRONT_BIT, &front }, { VK_STENCIL_FACE_BACK_BIT, &back } })
+                    vkCmdSetStencilOp(commandBuffer, faceMask, state->failOp, state->passOp, state->depthFailOp, state->compareOp),
+                    vkCmdSetStencilCompareMask(commandBuffer, faceMask, state->compareMask),
+                    vkCmdSetStencilWriteMask(commandBuffer, faceMask, state->writeMask),
+                    vkCmdSetStencilReference(commandBuffer, faceMask, state->reference);
+            //״̬ӦԿʱҪҲֻдʱܣ
+            if (features.depthClamp)
+                functions.vkCmdSetDepthClampEnableEXT(commandBuffer, depthClampEnable);
+            if (features.alphaToOne)
+                functions.vkCmdSetAlphaToOneEnableEXT(commandBuffer, alphaToOneEnable);
+            if (features.depthBounds) {
+                vkCmdSetDepthBoundsTestEnable(commandBuffer, depthBoundsTestEnable);
+                if (depthBoundsTestEnable)
+                    vkCmdSetDepthBounds(commandBuffer, minDepthBounds, maxDepthBounds);
+            }
+            if (features.logicOp) {
+                functions.vkCmdSetLogicOpEnableEXT(commandBuffer, logicOpEnable);
+                if (logicOpEnable)
+                    functions.vkCmdSetLogicOpEXT(commandBuffer, logicOp);
+            }
+            vkCmdSetBlendConstants(commandBuffer, blendConstants);
+            if (uint32_t count = uint32_t(colorBlendEnables.size())) {
+                functions.vkCmdSetColorBlendEnableEXT(commandBuffer, 0, count, colorBlendEnables.data());
+                functions.vkCmdSetColorBlendEquationEXT(commandBuffer, 0, count, colorBlendEquations.data());
+                functions.vkCmdSetColorWriteMaskEXT(commandBuffer, 0, count, colorWriteMasks.data());
+            }
+        }
+    };
+}
\ No newline at end of file
@@ -16,6 +16,9 @@
 #define DefineHandleTypeOperator operator decltype(handle)() const { return handle; }
 #define DefineAddressFunction const decltype(handle)* Address() const { return &handle; }
 
+//扩展函数须经vkGetDeviceProcAddr(...)取得，用到该宏的类在首次使用时加载
+#define DeviceProcAddr(name) reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(graphicsBase::Base().Device(), #name))
+
 #define ExecuteOnce(...) { static bool executed = false; if (executed) return __VA_ARGS__; executed = true; }
 
 // define vulkan namespace
@@ -102,6 +105,100 @@ namespace vulkan {
 		arrayRef& operator=(const arrayRef&) = delete;
 	};
 
+	//定长容量的vector，元素存放在对象内部，不分配堆内存，T可平凡复制时其本身也可平凡复制（可直接memcpy搬移）
+	//超出容量视为程序错误
+	template<typename T, uint32_t capacity>
+	class fixedVector {
+		static_assert(std::is_trivially_copyable_v<T>);
+		T elements[capacity] = {};
+		uint32_t count = 0;
+	public:
+		constexpr fixedVector() = default;
+		constexpr fixedVector(std::initializer_list<T> list) {
+			for (auto& i : list)
+				push_back(i);
+		}
+		//Getter
+		constexpr T* data() { return elements; }
+		constexpr const T* data() const { return elements; }
+		constexpr uint32_t size() const { return count; }
+		constexpr bool empty() const { return !count; }
+		static constexpr uint32_t max_size() { return capacity; }
+		//Const Function
+		constexpr T& operator[](size_t index) { return elements[index]; }
+		constexpr const T& operator[](size_t index) const { return elements[index]; }
+		constexpr T* begin() { return elements; }
+		constexpr T* end() { return elements + count; }
+		constexpr const T* begin() const { return elements; }
+		constexpr const T* end() const { return elements + count; }
+		constexpr T& back() { return elements[count - 1]; }
+		//Non-const Function
+		constexpr void push_back(const T& element) {
+			if (count == capacity)
+				outStream << std::format("[ fixedVector ] ERROR\nCapacity {} exceeded!\n", capacity),
+				abort();
+			elements[count++] = element;
+		}
+		template<typename... Args>
+		constexpr T& emplace_back(Args&&... args) {
+			push_back(T{ std::forward<Args>(args)... });
+			return back();
+		}
+		constexpr void pop_back() { count--; }
+		constexpr void resize(uint32_t newCount) {
+			if (newCount > capacity)
+				outStream << std::format("[ fixedVector ] ERROR\nCapacity {} exceeded!\n", capacity),
+				abort();
+			for (uint32_t i = count; i < newCount; i++)
+				elements[i] = {};
+			count = newCount;
+		}
+		constexpr void clear() { count = 0; }
+		template<std::input_iterator iterator>
+		constexpr void assign(iterator begin, iterator end) {
+			clear();
+			for (; begin != end; ++begin)
+				push_back(*begin);
+		}
+	};
+
+	//被换下的对象可能仍被在途的命令缓冲区引用，先放在这里，过framesInFlight帧后再析构，非线程安全
+	template<typename T>
+	class retiredObjects {
+		struct retired {
+			T object;
+			uint32_t framesLeft;
+		};
+		std::vector<retired> objects;
+	public:
+		//Getter
+		size_t Count() const { return objects.size(); }
+		//Non-const Function
+		//framesInFlight为0时按1处理，即最早在下一次NextFrame()时析构
+		void Retire(T&& object, uint32_t framesInFlight) {
+			objects.emplace_back(std::move(object), std::max(framesInFlight, 1u));
+		}
+		//在帧边界（栅栏等待之后）调用，析构已过framesInFlight帧的对象
+		void NextFrame() {
+			for (auto& i : objects)
+				i.framesLeft--;
+			std::erase_if(objects, [](const retired& i) { return !i.framesLeft; });
+		}
+	};
+
+	//FNV-1a散列，用于各种缓存的键，hash参数用于将多段数据的散列值串起来
+	inline uint64_t HashBytes(const void* pData, size_t size, uint64_t hash = 14695981039346656037ull) {
+		for (size_t i = 0; i < size; i++)
+			hash = (hash ^ static_cast<const uint8_t*>(pData)[i]) * 1099511628211ull;
+		return hash;
+	}
+	//注意结构体中的填充字节也会被散列，对含填充的类型应逐成员散列
+	template<typename T>
+	uint64_t HashObject(const T& data, uint64_t hash = 14695981039346656037ull) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		return HashBytes(&data, sizeof data, hash);
+	}
+
 
 	// 单例类
 	class graphicsBase {
@@ -130,8 +227,27 @@ namespace vulkan {
 		VkQueue queue_graphics; // 图形
 		VkQueue queue_presentation; // 呈现
 		VkQueue queue_compute; // 计算
+		//队列须外部同步，图形、呈现、计算可能是同一队列，一律以此互斥量保护，使其他线程（如oneShotExecutor）也能安全地提交
+		mutable std::mutex queueMutex;
 
 		std::vector<const char*> deviceExtensions;
+		//可选的设备扩展，物理设备支持时才在CreateDevice(...)中启用，其特性/属性结构体被接入相应的pNext链
+		struct optionalDeviceExtension {
+			const char* name;
+			void* pFeatures;
+			void* pProperties;
+		};
+		std::vector<optionalDeviceExtension> optionalDeviceExtensions;
+		void* pNext_physicalDeviceFeatures = nullptr;
+		void* pNext_physicalDeviceProperties = nullptr;
+		VkPhysicalDeviceFeatures2 physicalDeviceFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+		VkPhysicalDeviceVulkan11Features physicalDeviceVulkan11Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES };
+		VkPhysicalDeviceVulkan12Features physicalDeviceVulkan12Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+		VkPhysicalDeviceVulkan13Features physicalDeviceVulkan13Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES };
+		VkPhysicalDeviceShaderObjectFeaturesEXT physicalDeviceShaderObjectFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT };
+		VkPhysicalDevicePushDescriptorPropertiesKHR physicalDevicePushDescriptorProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PUSH_DESCRIPTOR_PROPERTIES_KHR };
+		VkPhysicalDeviceDescriptorBufferFeaturesEXT physicalDeviceDescriptorBufferFeatures = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT };
+		VkPhysicalDeviceDescriptorBufferPropertiesEXT physicalDeviceDescriptorBufferProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT };
 
 		std::vector <VkSurfaceFormatKHR> availableSurfaceFormats;
 
@@ -141,6 +257,8 @@ namespace vulkan {
 		VkSwapchainCreateInfoKHR swapchainCreateInfo = {}; //保存交换链的创建信息以便重建交换链
 		std::vector<std::function<void()>> callbacks_createSwapchain;  // 提升程序的可维护性
 		std::vector<std::function<void()>> callbacks_destroySwapchain;
+		std::vector<std::pair<uint64_t, std::function<void(VkImageView)>>> callbacks_destroyImageView; //（回调ID，回调函数）
+		uint64_t lastCallbackId_destroyImageView = 0;
 
 		//当前取得的交换链图像索引
 		uint32_t currentImageIndex = 0;
@@ -291,6 +409,12 @@ namespace vulkan {
 			return VK_RESULT_MAX_ENUM;
 		}
 
+		//该函数用于将结构体接入pNext链的开头
+		static void SetPNext(void*& pBegin, void* pNext) {
+			reinterpret_cast<VkBaseOutStructure*>(pNext)->pNext = reinterpret_cast<VkBaseOutStructure*>(pBegin);
+			pBegin = pNext;
+		}
+
 		//该函数用于向instanceLayers或instanceExtensions容器中添加字符串指针，并确保不重复
 		static void AddLayerOrExtension(std::vector<const char*>& container, const char* name) {
 			for (auto& i : container)
@@ -384,6 +508,64 @@ namespace vulkan {
 			return deviceExtensions;
 		}
 
+		bool IsDeviceExtensionEnabled(const char* extensionName) const {
+			for (auto& i : deviceExtensions)
+				if (!strcmp(extensionName, i))
+					return true;
+			return false;
+		}
+
+		//物理设备和实例所支持的最高API版本中较低的那个
+		uint32_t DeviceApiVersion() const {
+			return std::min(apiVersion, physicalDeviceProperties.apiVersion);
+		}
+
+		const VkPhysicalDeviceFeatures& PhysicalDeviceFeatures() const {
+			return physicalDeviceFeatures.features;
+		}
+
+		const VkPhysicalDeviceVulkan11Features& PhysicalDeviceVulkan11Features() const {
+			return physicalDeviceVulkan11Features;
+		}
+
+		const VkPhysicalDeviceVulkan12Features& PhysicalDeviceVulkan12Features() const {
+			return physicalDeviceVulkan12Features;
+		}
+
+		const VkPhysicalDeviceVulkan13Features& PhysicalDeviceVulkan13Features() const {
+			return physicalDeviceVulkan13Features;
+		}
+
+		//VK_EXT_shader_object是否可用，需在创建逻辑设备前调用过RequestShaderObject()
+		bool ShaderObjectAvailable() const {
+			return DeviceApiVersion() >= VK_API_VERSION_1_3 &&
+				physicalDeviceVulkan13Features.dynamicRendering &&
+				physicalDeviceShaderObjectFeatures.shaderObject &&
+				IsDeviceExtensionEnabled(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+		}
+
+		const VkPhysicalDevicePushDescriptorPropertiesKHR& PhysicalDevicePushDescriptorProperties() const {
+			return physicalDevicePushDescriptorProperties;
+		}
+
+		//VK_KHR_push_descriptor是否可用，需在创建逻辑设备前调用过RequestPushDescriptor()
+		bool PushDescriptorAvailable() const {
+			return physicalDevicePushDescriptorProperties.maxPushDescriptors &&
+				IsDeviceExtensionEnabled(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+		}
+
+		const VkPhysicalDeviceDescriptorBufferPropertiesEXT& PhysicalDeviceDescriptorBufferProperties() const {
+			return physicalDeviceDescriptorBufferProperties;
+		}
+
+		//VK_EXT_descriptor_buffer是否可用，需在创建逻辑设备前调用过RequestDescriptorBuffer()，其依赖的缓冲区设备地址取自Vulkan1.2核心特性
+		bool DescriptorBufferAvailable() const {
+			return DeviceApiVersion() >= VK_API_VERSION_1_2 &&
+				physicalDeviceVulkan12Features.bufferDeviceAddress &&
+				physicalDeviceDescriptorBufferFeatures.descriptorBuffer &&
+				IsDeviceExtensionEnabled(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+		}
+
 		const VkFormat& AvailableSurfaceFormat(uint32_t index) const {
 			return availableSurfaceFormats[index].format;
 		}
@@ -570,6 +752,7 @@ namespace vulkan {
 
 			swapchainCreateInfo.oldSwapchain = swapchain;
 
+			std::unique_lock lock(queueMutex);
 			VkResult result = vkQueueWaitIdle(queue_graphics);
 			//仅在等待图形队列成功，且图形与呈现所用队列不同时等待呈现队列
 			if (!result &&
@@ -579,12 +762,14 @@ namespace vulkan {
 				outStream << std::format("[ graphicsBase ] ERROR\nFailed to wait for the queue to be idle!\nError code: {}\n", int32_t(result));
 				return result;
 			}
+			lock.unlock();
 
 			//销毁旧交换链相关对象
 			ExecuteCallbacks(callbacks_destroySwapchain);
 			// 销毁旧有的image view
 			for (auto& i : swapchainImageViews)
 				if (i)
+					ExecuteCallbacks_DestroyImageView(i),
 					vkDestroyImageView(device, i, nullptr);
 			swapchainImageViews.resize(0);
 			//创建新交换链及与之相关的对象
@@ -595,6 +780,20 @@ namespace vulkan {
 			return VK_SUCCESS;
 		}
 
+		//image view被销毁前调用，供缓存了帧缓冲等引用了image view的对象的地方将其剔除
+		//返回回调ID，注册回调的对象须在析构前以此ID调用RemoveCallback_DestroyImageView(...)
+		uint64_t AddCallback_DestroyImageView(std::function<void(VkImageView)> function) {
+			callbacks_destroyImageView.emplace_back(++lastCallbackId_destroyImageView, std::move(function));
+			return lastCallbackId_destroyImageView;
+		}
+		void RemoveCallback_DestroyImageView(uint64_t callbackId) {
+			std::erase_if(callbacks_destroyImageView, [callbackId](auto& callback) { return callback.first == callbackId; });
+		}
+		void ExecuteCallbacks_DestroyImageView(VkImageView imageView) const {
+			for (auto& [callbackId, function] : callbacks_destroyImageView)
+				function(imageView);
+		}
+
 		void AddCallback_CreateSwapchain(std::function<void()> function) {
 			callbacks_createSwapchain.push_back(function);
 		}
@@ -605,6 +804,7 @@ namespace vulkan {
 		//该函数用于将命令缓冲区提交到用于图形的队列
 		result_t SubmitCommandBuffer_Graphics(VkSubmitInfo& submitInfo, VkFence fence = VK_NULL_HANDLE) const {
 			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			std::lock_guard lock(queueMutex);
 			VkResult result = vkQueueSubmit(queue_graphics, 1, &submitInfo, fence);
 			if (result)
 				outStream << std::format("[ graphicsBase ] ERROR\nFailed to submit the command buffer!\nError code: {}\n", int32_t(result));
@@ -638,6 +838,7 @@ namespace vulkan {
 		//该函数用于将命令缓冲区提交到用于计算的队列
 		result_t SubmitCommandBuffer_Compute(VkSubmitInfo& submitInfo, VkFence fence = VK_NULL_HANDLE) const {
 			submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+			std::lock_guard lock(queueMutex);
 			VkResult result = vkQueueSubmit(queue_compute, 1, &submitInfo, fence);
 			if (result)
 				outStream << std::format("[ graphicsBase ] ERROR\nFailed to submit the command buffer!\nError code: {}\n", int32_t(result));
@@ -654,7 +855,12 @@ namespace vulkan {
 
 		result_t PresentImage(VkPresentInfoKHR& presentInfo) {
 			presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-			switch (VkResult result = vkQueuePresentKHR(queue_presentation, &presentInfo)) {
+			VkResult result;
+			{
+				std::lock_guard lock(queueMutex);
+				result = vkQueuePresentKHR(queue_presentation, &presentInfo);
+			}
+			switch (result) {
 			case VK_SUCCESS:
 				return VK_SUCCESS;
 			case VK_SUBOPTIMAL_KHR:
@@ -826,6 +1032,26 @@ namespace vulkan {
 		void AddDeviceExtension(const char* extensionName) {
 			AddLayerOrExtension(deviceExtensions, extensionName);
 		}
+		//该函数用于创建逻辑设备前，物理设备支持该扩展时才启用，并启用pFeatures中所有受支持的特性、在创建设备后向pProperties中写入属性
+		//pFeatures和pProperties需设置好sType且在整个程序运行期间有效，已被提升为核心功能的特性请通过PhysicalDeviceVulkan1xFeatures()查询
+		void AddOptionalDeviceExtension(const char* extensionName, void* pFeatures = nullptr, void* pProperties = nullptr) {
+			for (auto& i : optionalDeviceExtensions)
+				if (!strcmp(extensionName, i.name))
+					return;
+			optionalDeviceExtensions.push_back({ extensionName, pFeatures, pProperties });
+		}
+		//该函数用于创建逻辑设备前，物理设备支持时启用VK_EXT_shader_object，其依赖的动态渲染取自Vulkan1.3核心特性
+		void RequestShaderObject() {
+			AddOptionalDeviceExtension(VK_EXT_SHADER_OBJECT_EXTENSION_NAME, &physicalDeviceShaderObjectFeatures);
+		}
+		//该函数用于创建逻辑设备前，物理设备支持时启用VK_KHR_push_descriptor，并取得单个描述符集可推送的描述符个数上限
+		void RequestPushDescriptor() {
+			AddOptionalDeviceExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, nullptr, &physicalDevicePushDescriptorProperties);
+		}
+		//该函数用于创建逻辑设备前，物理设备支持时启用VK_EXT_descriptor_buffer，并取得各类描述符的大小及对齐要求
+		void RequestDescriptorBuffer() {
+			AddOptionalDeviceExtension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, &physicalDeviceDescriptorBufferFeatures, &physicalDeviceDescriptorBufferProperties);
+		}
 
 		//该函数用于获取物理设备
 		result_t GetPhysicalDevices() {
@@ -923,17 +1149,50 @@ namespace vulkan {
 				queueFamilyIndex_compute != queueFamilyIndex_graphics &&
 				queueFamilyIndex_compute != queueFamilyIndex_presentation)
 				queueCreateInfos[queueCreateInfoCount++].queueFamilyIndex = queueFamilyIndex_compute;
-			VkPhysicalDeviceFeatures physicalDeviceFeatures;
-			vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures);
+			vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+			//启用物理设备所支持的可选扩展，并将其特性/属性结构体接入pNext链
+			pNext_physicalDeviceFeatures = pNext_physicalDeviceProperties = nullptr;
+			if (optionalDeviceExtensions.size()) {
+				std::vector<const char*> extensionNames;
+				for (auto& i : optionalDeviceExtensions)
+					extensionNames.push_back(i.name);
+				if (VkResult result = CheckDeviceExtensions(extensionNames))
+					return result;
+				for (size_t i = 0; i < extensionNames.size(); i++)
+					if (extensionNames[i]) {
+						AddDeviceExtension(extensionNames[i]);
+						if (optionalDeviceExtensions[i].pFeatures)
+							SetPNext(pNext_physicalDeviceFeatures, optionalDeviceExtensions[i].pFeatures);
+						if (optionalDeviceExtensions[i].pProperties)
+							SetPNext(pNext_physicalDeviceProperties, optionalDeviceExtensions[i].pProperties);
+					}
+			}
+			//查询并启用所有受支持的特性，Vulkan1.1以上通过VkPhysicalDeviceFeatures2的pNext链查询核心及扩展特性
 			VkDeviceCreateInfo deviceCreateInfo = {
 				.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
 				.flags = flags,
 				.queueCreateInfoCount = queueCreateInfoCount,
 				.pQueueCreateInfos = queueCreateInfos,
 				.enabledExtensionCount = uint32_t(deviceExtensions.size()),
-				.ppEnabledExtensionNames = deviceExtensions.data(),
-				.pEnabledFeatures = &physicalDeviceFeatures
+				.ppEnabledExtensionNames = deviceExtensions.data()
 			};
+			if (DeviceApiVersion() >= VK_API_VERSION_1_1) {
+				void* pNext = pNext_physicalDeviceFeatures;
+				if (DeviceApiVersion() >= VK_API_VERSION_1_3)
+					SetPNext(pNext, &physicalDeviceVulkan13Features);
+				if (DeviceApiVersion() >= VK_API_VERSION_1_2)
+					SetPNext(pNext, &physicalDeviceVulkan12Features),
+					SetPNext(pNext, &physicalDeviceVulkan11Features);
+				physicalDeviceFeatures.pNext = pNext;
+				vkGetPhysicalDeviceFeatures2(physicalDevice, &physicalDeviceFeatures);
+				//捕获重放仅供调试工具使用，忽略图像布局未被用到，启用它们可能使驱动生成较慢的描述符
+				physicalDeviceDescriptorBufferFeatures.descriptorBufferCaptureReplay = VK_FALSE;
+				physicalDeviceDescriptorBufferFeatures.descriptorBufferImageLayoutIgnored = VK_FALSE;
+				deviceCreateInfo.pNext = &physicalDeviceFeatures;
+			}
+			else
+				vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures.features),
+				deviceCreateInfo.pEnabledFeatures = &physicalDeviceFeatures.features;
 			if (VkResult result = vkCreateDevice(physicalDevice, &deviceCreateInfo, nullptr, &device)) {
 				outStream << std::format("[ graphicsBase ] ERROR\nFailed to create a vulkan logical device!\nError code: {}\n", int32_t(result));
 				return result;
@@ -944,7 +1203,13 @@ namespace vulkan {
 				vkGetDeviceQueue(device, queueFamilyIndex_presentation, 0, &queue_presentation);
 			if (queueFamilyIndex_compute != VK_QUEUE_FAMILY_IGNORED)
 				vkGetDeviceQueue(device, queueFamilyIndex_compute, 0, &queue_compute);
-			vkGetPhysicalDeviceProperties(physicalDevice, &physicalDeviceProperties);
+			if (pNext_physicalDeviceProperties && DeviceApiVersion() >= VK_API_VERSION_1_1) {
+				VkPhysicalDeviceProperties2 physicalDeviceProperties2 = {
+					.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+					.pNext = pNext_physicalDeviceProperties
+				};
+				vkGetPhysicalDeviceProperties2(physicalDevice, &physicalDeviceProperties2);
+			}
 			vkGetPhysicalDeviceMemoryProperties(physicalDevice, &physicalDeviceMemoryProperties);
 			//输出所用的物理设备名称
 			outStream << std::format("Renderer: {}\n", physicalDeviceProperties.deviceName);
@@ -961,6 +1226,7 @@ namespace vulkan {
 		}
 
 		result_t WaitIdle() const {
+			std::lock_guard lock(queueMutex);
 			VkResult result = vkDeviceWaitIdle(device);
 			if (result)
 				outStream << std::format("[ graphicsBase ] ERROR\nFailed to wait for the device to be idle!\nError code: {}\n", int32_t(result));
@@ -969,7 +1235,34 @@ namespace vulkan {
 
 		//以下函数用于创建逻辑设备失败后
 		result_t CheckDeviceExtensions(std::span<const char*> extensionsToCheck, const char* layerName = nullptr) const {
-			/*待Ch1-3填充*/
+			uint32_t extensionCount;
+			std::vector<VkExtensionProperties> availableExtensions;
+			if (VkResult result = vkEnumerateDeviceExtensionProperties(physicalDevice, layerName, &extensionCount, nullptr)) {
+				layerName ?
+					outStream << std::format("[ graphicsBase ] ERROR\nFailed to get the count of device extensions!\nLayer name:{}\n", layerName) :
+					outStream << std::format("[ graphicsBase ] ERROR\nFailed to get the count of device extensions!\n");
+				return result;
+			}
+			if (extensionCount) {
+				availableExtensions.resize(extensionCount);
+				if (VkResult result = vkEnumerateDeviceExtensionProperties(physicalDevice, layerName, &extensionCount, availableExtensions.data())) {
+					outStream << std::format("[ graphicsBase ] ERROR\nFailed to enumerate device extension properties!\nError code: {}\n", int32_t(result));
+					return result;
+				}
+				for (auto& i : extensionsToCheck) {
+					bool found = false;
+					for (auto& j : availableExtensions)
+						if (!strcmp(i, j.extensionName)) {
+							found = true;
+							break;
+						}
+					if (!found)
+						i = nullptr;
+				}
+			}
+			else
+				for (auto& i : extensionsToCheck)
+					i = nullptr;
 			return VK_SUCCESS;
 		}
 
@@ -1114,6 +1407,41 @@ namespace vulkan {
 				outStream << std::format("[ commandBuffer ] ERROR\nFailed to end a command buffer!\nError code: {}\n", int32_t(result));
 			return result;
 		}
+		//动态渲染（Vulkan1.3核心功能），直接以image view为附件，不需要渲染通道和帧缓冲
+		void CmdBeginRendering(VkRenderingInfo& renderingInfo) const {
+			renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+			vkCmdBeginRendering(handle, &renderingInfo);
+		}
+		void CmdBeginRendering(VkRect2D renderArea, arrayRef<const VkRenderingAttachmentInfo> colorAttachments,
+			const VkRenderingAttachmentInfo* pDepthAttachment = nullptr, const VkRenderingAttachmentInfo* pStencilAttachment = nullptr,
+			uint32_t layerCount = 1, VkRenderingFlags flags = 0) const {
+			VkRenderingInfo renderingInfo = {
+				.flags = flags,
+				.renderArea = renderArea,
+				.layerCount = layerCount,
+				.colorAttachmentCount = uint32_t(colorAttachments.Count()),
+				.pColorAttachments = colorAttachments.Pointer(),
+				.pDepthAttachment = pDepthAttachment,
+				.pStencilAttachment = pStencilAttachment
+			};
+			CmdBeginRendering(renderingInfo);
+		}
+		void CmdEndRendering() const {
+			vkCmdEndRendering(handle);
+		}
+		//Static Function
+		//填写动态渲染的附件，imageLayout为渲染期间附件所处的内存布局
+		static VkRenderingAttachmentInfo RenderingAttachment(VkImageView imageView, VkAttachmentLoadOp loadOp, VkAttachmentStoreOp storeOp,
+			VkClearValue clearValue = {}, VkImageLayout imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL) {
+			return {
+				.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+				.imageView = imageView,
+				.imageLayout = imageLayout,
+				.loadOp = loadOp,
+				.storeOp = storeOp,
+				.clearValue = clearValue
+			};
+		}
 	};
 
 
@@ -1157,6 +1485,13 @@ namespace vulkan {
 		void FreeBuffers(arrayRef<commandBuffer> buffers) const {
 			FreeBuffers({ &buffers[0].handle, buffers.Count() });
 		}
+		//重置命令池，从中分配的命令缓冲区一并回到初始状态，比逐个重置命令缓冲区开销小
+		result_t Reset(VkCommandPoolResetFlags flags = 0) const {
+			VkResult result = vkResetCommandPool(graphicsBase::Base().Device(), handle, flags);
+			if (result)
+				outStream << std::format("[ commandPool ] ERROR\nFailed to reset a command pool!\nError code: {}\n", int32_t(result));
+			return result;
+		}
 		//Non-const Function
 		result_t Create(VkCommandPoolCreateInfo& createInfo) {
 			createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -1174,6 +1509,246 @@ namespace vulkan {
 		}
 	};
 
+	class deviceMemory {
+		VkDeviceMemory handle = VK_NULL_HANDLE;
+		VkDeviceSize allocationSize = 0; //实际分配的大小
+		VkMemoryPropertyFlags memoryProperties = 0;
+		//非host coherent的内存，映射和刷新的范围须对齐到nonCoherentAtomSize，返回调整后的offset比原来小了多少
+		VkDeviceSize AdjustNonCoherentMemoryRange(VkDeviceSize& size, VkDeviceSize& offset) const {
+			const VkDeviceSize nonCoherentAtomSize = graphicsBase::Base().PhysicalDeviceProperties().limits.nonCoherentAtomSize;
+			VkDeviceSize originalOffset = offset;
+			offset = offset / nonCoherentAtomSize * nonCoherentAtomSize;
+			size = std::min((originalOffset + size + nonCoherentAtomSize - 1) / nonCoherentAtomSize * nonCoherentAtomSize, allocationSize) - offset;
+			return originalOffset - offset;
+		}
+	public:
+		deviceMemory() = default;
+		deviceMemory(VkMemoryAllocateInfo& allocateInfo) {
+			Allocate(allocateInfo);
+		}
+		deviceMemory(deviceMemory&& other) noexcept {
+			MoveHandle;
+			allocationSize = other.allocationSize;
+			memoryProperties = other.memoryProperties;
+			other.allocationSize = 0;
+			other.memoryProperties = 0;
+		}
+		~deviceMemory() {
+			DestroyHandleBy(vkFreeMemory);
+			allocationSize = 0;
+			memoryProperties = 0;
+		}
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		VkDeviceSize AllocationSize() const { return allocationSize; }
+		VkMemoryPropertyFlags MemoryProperties() const { return memoryProperties; }
+		//Const Function
+		//映射host visible的内存，非host coherent时自动调整映射范围，pData指向offset处
+		result_t MapMemory(void*& pData, VkDeviceSize size, VkDeviceSize offset = 0) const {
+			VkDeviceSize inverseDeltaOffset = 0;
+			if (!(memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+				inverseDeltaOffset = AdjustNonCoherentMemoryRange(size, offset);
+			if (VkResult result = vkMapMemory(graphicsBase::Base().Device(), handle, offset, size, 0, &pData)) {
+				outStream << std::format("[ deviceMemory ] ERROR\nFailed to map the memory!\nError code: {}\n", int32_t(result));
+				return result;
+			}
+			if (!(memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+				pData = static_cast<uint8_t*>(pData) + inverseDeltaOffset;
+				VkMappedMemoryRange mappedMemoryRange = {
+					.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+					.memory = handle,
+					.offset = offset,
+					.size = size
+				};
+				if (VkResult result = vkInvalidateMappedMemoryRanges(graphicsBase::Base().Device(), 1, &mappedMemoryRange)) {
+					outStream << std::format("[ deviceMemory ] ERROR\nFailed to invalidate the memory!\nError code: {}\n", int32_t(result));
+					return result;
+				}
+			}
+			return VK_SUCCESS;
+		}
+		//取消映射，非host coherent时先刷新写入的范围
+		result_t UnmapMemory(VkDeviceSize size, VkDeviceSize offset = 0) const {
+			if (!(memoryProperties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+				AdjustNonCoherentMemoryRange(size, offset);
+				VkMappedMemoryRange mappedMemoryRange = {
+					.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+					.memory = handle,
+					.offset = offset,
+					.size = size
+				};
+				if (VkResult result = vkFlushMappedMemoryRanges(graphicsBase::Base().Device(), 1, &mappedMemoryRange)) {
+					outStream << std::format("[ deviceMemory ] ERROR\nFailed to flush the memory!\nError code: {}\n", int32_t(result));
+					return result;
+				}
+			}
+			vkUnmapMemory(graphicsBase::Base().Device(), handle);
+			return VK_SUCCESS;
+		}
+		//映射、复制、取消映射，用于不常更新的数据
+		result_t BufferData(const void* pData_src, VkDeviceSize size, VkDeviceSize offset = 0) const {
+			void* pData_dst;
+			if (VkResult result = MapMemory(pData_dst, size, offset))
+				return result;
+			memcpy(pData_dst, pData_src, size_t(size));
+			return UnmapMemory(size, offset);
+		}
+		//Non-const Function
+		result_t Allocate(VkMemoryAllocateInfo& allocateInfo) {
+			if (allocateInfo.memoryTypeIndex >= graphicsBase::Base().PhysicalDeviceMemoryProperties().memoryTypeCount) {
+				outStream << std::format("[ deviceMemory ] ERROR\nInvalid memory type index!\n");
+				return VK_RESULT_MAX_ENUM;
+			}
+			allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			if (VkResult result = vkAllocateMemory(graphicsBase::Base().Device(), &allocateInfo, nullptr, &handle)) {
+				outStream << std::format("[ deviceMemory ] ERROR\nFailed to allocate memory!\nError code: {}\n", int32_t(result));
+				return result;
+			}
+			allocationSize = allocateInfo.allocationSize;
+			memoryProperties = graphicsBase::Base().PhysicalDeviceMemoryProperties().memoryTypes[allocateInfo.memoryTypeIndex].propertyFlags;
+			return VK_SUCCESS;
+		}
+	};
+
+	class buffer {
+		VkBuffer handle = VK_NULL_HANDLE;
+	public:
+		buffer() = default;
+		buffer(VkBufferCreateInfo& createInfo) {
+			Create(createInfo);
+		}
+		buffer(buffer&& other) noexcept { MoveHandle; }
+		~buffer() { DestroyHandleBy(vkDestroyBuffer); }
+		DefineMoveAssignmentOperator(buffer);
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Const Function
+		//取得分配内存所需的信息，memoryTypeIndex为满足desiredMemoryProperties的首个内存类型，无满足者时为UINT32_MAX
+		VkMemoryAllocateInfo MemoryAllocateInfo(VkMemoryPropertyFlags desiredMemoryProperties) const {
+			VkMemoryAllocateInfo memoryAllocateInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+			VkMemoryRequirements memoryRequirements;
+			vkGetBufferMemoryRequirements(graphicsBase::Base().Device(), handle, &memoryRequirements);
+			memoryAllocateInfo.allocationSize = memoryRequirements.size;
+			memoryAllocateInfo.memoryTypeIndex = UINT32_MAX;
+			auto& physicalDeviceMemoryProperties = graphicsBase::Base().PhysicalDeviceMemoryProperties();
+			for (uint32_t i = 0; i < physicalDeviceMemoryProperties.memoryTypeCount; i++)
+				if (memoryRequirements.memoryTypeBits & 1 << i &&
+					(physicalDeviceMemoryProperties.memoryTypes[i].propertyFlags & desiredMemoryProperties) == desiredMemoryProperties) {
+					memoryAllocateInfo.memoryTypeIndex = i;
+					break;
+				}
+			return memoryAllocateInfo;
+		}
+		result_t BindMemory(VkDeviceMemory deviceMemory, VkDeviceSize memoryOffset = 0) const {
+			VkResult result = vkBindBufferMemory(graphicsBase::Base().Device(), handle, deviceMemory, memoryOffset);
+			if (result)
+				outStream << std::format("[ buffer ] ERROR\nFailed to attach the memory!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		//须以VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT创建，需Vulkan1.2的bufferDeviceAddress特性
+		VkDeviceAddress DeviceAddress() const {
+			VkBufferDeviceAddressInfo addressInfo = {
+				.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+				.buffer = handle
+			};
+			return vkGetBufferDeviceAddress(graphicsBase::Base().Device(), &addressInfo);
+		}
+		//Non-const Function
+		result_t Create(VkBufferCreateInfo& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+			VkResult result = vkCreateBuffer(graphicsBase::Base().Device(), &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ buffer ] ERROR\nFailed to create a buffer!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+	};
+
+	//缓冲区及其专用的设备内存
+	class bufferMemory :buffer, deviceMemory {
+	public:
+		bufferMemory() = default;
+		bufferMemory(VkBufferCreateInfo& createInfo, VkMemoryPropertyFlags desiredMemoryProperties) {
+			Create(createInfo, desiredMemoryProperties);
+		}
+		bufferMemory(bufferMemory&& other) noexcept :
+			buffer(std::move(other)), deviceMemory(std::move(other)) {}
+		~bufferMemory() = default;
+		bufferMemory& operator=(bufferMemory&& other) {
+			this->~bufferMemory();
+			new (this) bufferMemory(std::move(other));
+			return *this;
+		}
+		//Getter
+		VkBuffer Buffer() const { return static_cast<const buffer&>(*this); }
+		const VkBuffer* AddressOfBuffer() const { return buffer::Address(); }
+		VkDeviceMemory Memory() const { return static_cast<const deviceMemory&>(*this); }
+		const VkDeviceMemory* AddressOfMemory() const { return deviceMemory::Address(); }
+		using deviceMemory::AllocationSize;
+		using deviceMemory::MemoryProperties;
+		//Const Function
+		using deviceMemory::MapMemory;
+		using deviceMemory::UnmapMemory;
+		using deviceMemory::BufferData;
+		using buffer::DeviceAddress;
+		//Non-const Function
+		//用途含VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT时，内存以VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT分配
+		result_t Create(VkBufferCreateInfo& createInfo, VkMemoryPropertyFlags desiredMemoryProperties) {
+			if (VkResult result = buffer::Create(createInfo))
+				return result;
+			VkMemoryAllocateInfo allocateInfo = MemoryAllocateInfo(desiredMemoryProperties);
+			VkMemoryAllocateFlagsInfo allocateFlagsInfo = {
+				.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,
+				.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT
+			};
+			if (createInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT)
+				allocateInfo.pNext = &allocateFlagsInfo;
+			if (VkResult result = Allocate(allocateInfo))
+				return result;
+			return BindMemory(Memory());
+		}
+	};
+
+	class imageView {
+		VkImageView handle = VK_NULL_HANDLE;
+	public:
+		imageView() = default;
+		imageView(VkImageViewCreateInfo& createInfo) {
+			Create(createInfo);
+		}
+		imageView(VkImage image, VkImageViewType viewType, VkFormat format, const VkImageSubresourceRange& subresourceRange, VkImageViewCreateFlags flags = 0) {
+			Create(image, viewType, format, subresourceRange, flags);
+		}
+		imageView(imageView&& other) noexcept { MoveHandle; }
+		~imageView() {
+			if (handle)
+				graphicsBase::Base().ExecuteCallbacks_DestroyImageView(handle);
+			DestroyHandleBy(vkDestroyImageView);
+		}
+		DefineMoveAssignmentOperator(imageView);
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Non-const Function
+		result_t Create(VkImageViewCreateInfo& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			VkResult result = vkCreateImageView(graphicsBase::Base().Device(), &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ imageView ] ERROR\nFailed to create an image view!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		result_t Create(VkImage image, VkImageViewType viewType, VkFormat format, const VkImageSubresourceRange& subresourceRange, VkImageViewCreateFlags flags = 0) {
+			VkImageViewCreateInfo createInfo = {
+				.flags = flags,
+				.image = image,
+				.viewType = viewType,
+				.format = format,
+				.subresourceRange = subresourceRange
+			};
+			return Create(createInfo);
+		}
+	};
 
 	class renderPass {
 		VkRenderPass handle = VK_NULL_HANDLE;
@@ -1233,6 +1808,7 @@ namespace vulkan {
 		}
 		framebuffer(framebuffer&& other) noexcept { MoveHandle; }
 		~framebuffer() { DestroyHandleBy(vkDestroyFramebuffer); }
+		DefineMoveAssignmentOperator(framebuffer);
 		//Getter
 		DefineHandleTypeOperator;
 		DefineAddressFunction;
@@ -1266,7 +1842,7 @@ namespace vulkan {
 		DefineHandleTypeOperator;
 		DefineAddressFunction;
 		// const func
-		VkPipelineShaderStageCreateInfo StageCreateInfo(VkShaderStageFlagBits stage, const char* entry = "main") const {
+		VkPipelineShaderStageCreateInfo StageCreateInfo(VkShaderStageFlagBits stage, const char* entry = "main", const VkSpecializationInfo* pSpecializationInfo = nullptr) const {
 			return {
 				VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, //sType
 				nullptr,                                             //pNext
@@ -1274,10 +1850,24 @@ namespace vulkan {
 				stage,                                               //stage
 				handle,                                              //module
 				entry,                                               //pName
-				nullptr                                              //pSpecializationInfo
+				pSpecializationInfo                                  //pSpecializationInfo
 			};
 		
 		}
+		// static func
+		//该函数用于读取SPIR-V文件，热重载等需要在创建shader module前拿到字节码的地方也用它
+		static result_t ReadCode(const char* filepath, std::vector<uint32_t>& code) {
+			std::ifstream file(filepath, std::ios::ate | std::ios::binary);
+			if (!file) {
+				outStream << std::format("[ shader ] ERROR\nFailed to open the file: {}\n", filepath);
+				return VK_RESULT_MAX_ENUM; //没有合适的错误代码，别用VK_ERROR_UNKNOWN
+			}
+			size_t fileSize = static_cast<size_t>(file.tellg());
+			code.resize(fileSize / 4);
+			file.seekg(0);
+			file.read(reinterpret_cast<char*>(code.data()), code.size() * 4);
+			return VK_SUCCESS;
+		}
 		// non-const func
 		result_t Create(VkShaderModuleCreateInfo& createInfo) {
 			createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -1288,18 +1878,10 @@ namespace vulkan {
 		}
 
 		result_t Create(const char* filepath) {
-			std::ifstream file(filepath, std::ios::ate | std::ios::binary);
-			if (!file) {
-				outStream << std::format("[ shader ] ERROR\nFailed to open the file: {}\n", filepath);
-				return VK_RESULT_MAX_ENUM; //没有合适的错误代码，别用VK_ERROR_UNKNOWN
-			}
-			size_t fileSize = static_cast<size_t>(file.tellg());
-			std::vector<uint32_t> binaries(fileSize / 4);
-			file.seekg(0);
-			file.read(reinterpret_cast<char*>(binaries.data()), fileSize);
-			file.close();
-			
-			return Create(fileSize, binaries.data());
+			std::vector<uint32_t> binaries;
+			if (VkResult result = ReadCode(filepath, binaries))
+				return result;
+			return Create(binaries.size() * 4, binaries.data());
 		}
 
 		result_t Create(size_t codeSize, const uint32_t* pCode) {
@@ -1311,6 +1893,214 @@ namespace vulkan {
 		}
 	};
 
+	class descriptorSetLayout {
+		VkDescriptorSetLayout handle = VK_NULL_HANDLE;
+	public:
+		descriptorSetLayout() = default;
+		descriptorSetLayout(VkDescriptorSetLayoutCreateInfo& createInfo) {
+			Create(createInfo);
+		}
+		descriptorSetLayout(descriptorSetLayout&& other) noexcept { MoveHandle; }
+		~descriptorSetLayout() { DestroyHandleBy(vkDestroyDescriptorSetLayout); }
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Non-const Function
+		result_t Create(VkDescriptorSetLayoutCreateInfo& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+			VkResult result = vkCreateDescriptorSetLayout(graphicsBase::Base().Device(), &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ descriptorSetLayout ] ERROR\nFailed to create a descriptor set layout!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+	};
+
+	class descriptorSet {
+		friend class descriptorPool; //分配和释放描述符集的是descriptorPool
+		VkDescriptorSet handle = VK_NULL_HANDLE;
+	public:
+		descriptorSet() = default;
+		descriptorSet(descriptorSet&& other) noexcept { MoveHandle; }
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Const Function
+		void Write(arrayRef<const VkDescriptorImageInfo> descriptorInfos, VkDescriptorType descriptorType, uint32_t dstBinding = 0, uint32_t dstArrayElement = 0) const {
+			VkWriteDescriptorSet writeDescriptorSet = {
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = handle,
+				.dstBinding = dstBinding,
+				.dstArrayElement = dstArrayElement,
+				.descriptorCount = uint32_t(descriptorInfos.Count()),
+				.descriptorType = descriptorType,
+				.pImageInfo = descriptorInfos.Pointer()
+			};
+			Update(writeDescriptorSet);
+		}
+		void Write(arrayRef<const VkDescriptorBufferInfo> descriptorInfos, VkDescriptorType descriptorType, uint32_t dstBinding = 0, uint32_t dstArrayElement = 0) const {
+			VkWriteDescriptorSet writeDescriptorSet = {
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = handle,
+				.dstBinding = dstBinding,
+				.dstArrayElement = dstArrayElement,
+				.descriptorCount = uint32_t(descriptorInfos.Count()),
+				.descriptorType = descriptorType,
+				.pBufferInfo = descriptorInfos.Pointer()
+			};
+			Update(writeDescriptorSet);
+		}
+		void Write(arrayRef<const VkBufferView> descriptorInfos, VkDescriptorType descriptorType, uint32_t dstBinding = 0, uint32_t dstArrayElement = 0) const {
+			VkWriteDescriptorSet writeDescriptorSet = {
+				.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+				.dstSet = handle,
+				.dstBinding = dstBinding,
+				.dstArrayElement = dstArrayElement,
+				.descriptorCount = uint32_t(descriptorInfos.Count()),
+				.descriptorType = descriptorType,
+				.pTexelBufferView = descriptorInfos.Pointer()
+			};
+			Update(writeDescriptorSet);
+		}
+		//Static Function
+		static void Update(arrayRef<VkWriteDescriptorSet> writes, arrayRef<VkCopyDescriptorSet> copies = {}) {
+			for (auto& i : writes)
+				i.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			for (auto& i : copies)
+				i.sType = VK_STRUCTURE_TYPE_COPY_DESCRIPTOR_SET;
+			vkUpdateDescriptorSets(graphicsBase::Base().Device(), writes.Count(), writes.Pointer(), copies.Count(), copies.Pointer());
+		}
+	};
+
+	class descriptorPool {
+		VkDescriptorPool handle = VK_NULL_HANDLE;
+	public:
+		descriptorPool() = default;
+		descriptorPool(VkDescriptorPoolCreateInfo& createInfo) {
+			Create(createInfo);
+		}
+		descriptorPool(uint32_t maxSetCount, arrayRef<const VkDescriptorPoolSize> poolSizes, VkDescriptorPoolCreateFlags flags = 0) {
+			Create(maxSetCount, poolSizes, flags);
+		}
+		descriptorPool(descriptorPool&& other) noexcept { MoveHandle; }
+		~descriptorPool() { DestroyHandleBy(vkDestroyDescriptorPool); }
+		DefineMoveAssignmentOperator(descriptorPool);
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Const Function
+		//描述符集的个数须与布局的个数一致，pNext可接入VkDescriptorSetVariableDescriptorCountAllocateInfo等，池耗尽时返回VK_ERROR_OUT_OF_POOL_MEMORY或VK_ERROR_FRAGMENTED_POOL，此时不输出错误信息，由调用者决定是否另建新池
+		result_t AllocateSets(arrayRef<VkDescriptorSet> sets, arrayRef<const VkDescriptorSetLayout> setLayouts, const void* pNext = nullptr) const {
+			if (sets.Count() != setLayouts.Count()) {
+				if (sets.Count() > setLayouts.Count()) {
+					outStream << std::format("[ descriptorPool ] ERROR\nFor each descriptor set, must provide a corresponding layout!\n");
+					return VK_RESULT_MAX_ENUM;
+				}
+				else
+					outStream << std::format("[ descriptorPool ] WARNING\nProvided layouts are more than sets!\n");
+			}
+			if (!sets.Count())
+				return VK_SUCCESS;
+			VkDescriptorSetAllocateInfo allocateInfo = {
+				.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+				.pNext = pNext,
+				.descriptorPool = handle,
+				.descriptorSetCount = uint32_t(sets.Count()),
+				.pSetLayouts = setLayouts.Pointer()
+			};
+			VkResult result = vkAllocateDescriptorSets(graphicsBase::Base().Device(), &allocateInfo, sets.Pointer());
+			if (result && result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+				outStream << std::format("[ descriptorPool ] ERROR\nFailed to allocate descriptor sets!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		result_t AllocateSets(arrayRef<VkDescriptorSet> sets, arrayRef<const descriptorSetLayout> setLayouts, const void* pNext = nullptr) const {
+			return AllocateSets(
+				sets,
+				{ setLayouts.Count() ? setLayouts[0].Address() : nullptr, setLayouts.Count() },
+				pNext);
+		}
+		result_t AllocateSets(arrayRef<descriptorSet> sets, arrayRef<const VkDescriptorSetLayout> setLayouts, const void* pNext = nullptr) const {
+			return AllocateSets(
+				{ sets.Count() ? &sets[0].handle : nullptr, sets.Count() },
+				setLayouts,
+				pNext);
+		}
+		result_t AllocateSets(arrayRef<descriptorSet> sets, arrayRef<const descriptorSetLayout> setLayouts, const void* pNext = nullptr) const {
+			return AllocateSets(
+				{ sets.Count() ? &sets[0].handle : nullptr, sets.Count() },
+				{ setLayouts.Count() ? setLayouts[0].Address() : nullptr, setLayouts.Count() },
+				pNext);
+		}
+		//须以VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT创建
+		result_t FreeSets(arrayRef<VkDescriptorSet> sets) const {
+			if (!sets.Count())
+				return VK_SUCCESS;
+			VkResult result = vkFreeDescriptorSets(graphicsBase::Base().Device(), handle, sets.Count(), sets.Pointer());
+			memset(sets.Pointer(), 0, sets.Count() * sizeof(VkDescriptorSet));
+			return result; //Though vkFreeDescriptorSets(...) can only return VK_SUCCESS
+		}
+		result_t FreeSets(arrayRef<descriptorSet> sets) const {
+			return FreeSets({ sets.Count() ? &sets[0].handle : nullptr, sets.Count() });
+		}
+		//将池中所有描述符集一并回收，比逐个释放开销小
+		result_t Reset() const {
+			VkResult result = vkResetDescriptorPool(graphicsBase::Base().Device(), handle, 0);
+			if (result)
+				outStream << std::format("[ descriptorPool ] ERROR\nFailed to reset a descriptor pool!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		//Non-const Function
+		result_t Create(VkDescriptorPoolCreateInfo& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+			VkResult result = vkCreateDescriptorPool(graphicsBase::Base().Device(), &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ descriptorPool ] ERROR\nFailed to create a descriptor pool!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		result_t Create(uint32_t maxSetCount, arrayRef<const VkDescriptorPoolSize> poolSizes, VkDescriptorPoolCreateFlags flags = 0) {
+			VkDescriptorPoolCreateInfo createInfo = {
+				.flags = flags,
+				.maxSets = maxSetCount,
+				.poolSizeCount = uint32_t(poolSizes.Count()),
+				.pPoolSizes = poolSizes.Pointer()
+			};
+			return Create(createInfo);
+		}
+	};
+
+	//描述符更新模板（Vulkan1.1核心功能）：预先记下各描述符信息在一段数据中的偏移和步长，更新时直接从该数据读取，不必逐个填写VkWriteDescriptorSet
+	class descriptorUpdateTemplate {
+		VkDescriptorUpdateTemplate handle = VK_NULL_HANDLE;
+	public:
+		descriptorUpdateTemplate() = default;
+		descriptorUpdateTemplate(VkDescriptorUpdateTemplateCreateInfo& createInfo) {
+			Create(createInfo);
+		}
+		descriptorUpdateTemplate(descriptorUpdateTemplate&& other) noexcept { MoveHandle; }
+		~descriptorUpdateTemplate() { DestroyHandleBy(vkDestroyDescriptorUpdateTemplate); }
+		DefineMoveAssignmentOperator(descriptorUpdateTemplate);
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Const Function
+		//须以VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET创建
+		void Update(VkDescriptorSet set, const void* pData) const {
+			vkUpdateDescriptorSetWithTemplate(graphicsBase::Base().Device(), set, handle, pData);
+		}
+		//须以VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR创建，layout须与创建时的管线布局兼容，需启用VK_KHR_push_descriptor
+		void CmdPush(VkCommandBuffer commandBuffer, VkPipelineLayout layout, uint32_t set, const void* pData) const {
+			static const PFN_vkCmdPushDescriptorSetWithTemplateKHR vkCmdPushDescriptorSetWithTemplateKHR = DeviceProcAddr(vkCmdPushDescriptorSetWithTemplateKHR);
+			vkCmdPushDescriptorSetWithTemplateKHR(commandBuffer, handle, layout, set, pData);
+		}
+		//Non-const Function
+		result_t Create(VkDescriptorUpdateTemplateCreateInfo& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO;
+			VkResult result = vkCreateDescriptorUpdateTemplate(graphicsBase::Base().Device(), &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ descriptorUpdateTemplate ] ERROR\nFailed to create a descriptor update template!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+	};
+
 	class pipelineLayout {
 		VkPipelineLayout handle = VK_NULL_HANDLE;
 	public:
@@ -1333,38 +2123,347 @@ namespace vulkan {
 		}
 	};
 
+	//记录管线创建反馈（VK_EXT_pipeline_creation_feedback，Vulkan1.3起为核心功能）
+	//可用时，pipeline::Create(...)自动在pNext链上接入反馈结构体，将各管线及各阶段的编译耗时和缓存命中情况记入此处
+	class pipelineFeedback {
+	public:
+		struct record {
+			std::string name;
+			VkPipeline pipeline;
+			VkPipelineBindPoint bindPoint;
+			uint64_t frame;           //创建时的帧序号
+			bool usedCache;           //创建时是否提供了管线缓存
+			VkPipelineCreationFeedback feedback;
+			std::vector<std::pair<VkShaderStageFlagBits, VkPipelineCreationFeedback>> stages;
+			double Milliseconds() const { return feedback.duration / 1e6; }
+			bool CacheHit() const { return feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT; }
+		};
+		//在创建管线前构造、创建后调用Record(...)，期间将反馈结构体接在createInfo.pNext链的开头
+		class scope {
+			const void*& pNext;
+			const void* pNext_original;
+			VkPipelineCreationFeedbackCreateInfo feedbackCreateInfo = { VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO };
+			VkPipelineCreationFeedback feedback = {};
+			std::vector<VkPipelineCreationFeedback> stageFeedbacks;
+			const VkPipelineShaderStageCreateInfo* pStages;
+			VkPipelineBindPoint bindPoint;
+			bool usedCache;
+			bool active = false;
+		public:
+			scope(const void*& pNext, uint32_t stageCount, const VkPipelineShaderStageCreateInfo* pStages, VkPipelineBindPoint bindPoint, VkPipelineCache cache) :
+				pNext(pNext), pNext_original(pNext), pStages(pStages), bindPoint(bindPoint), usedCache(cache) {
+				if (!Available())
+					return;
+				//调用者已自行接入反馈结构体时不再接入
+				for (auto pStructure = static_cast<const VkBaseInStructure*>(pNext); pStructure; pStructure = pStructure->pNext)
+					if (pStructure->sType == VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO)
+						return;
+				stageFeedbacks.resize(stageCount);
+				feedbackCreateInfo.pNext = pNext;
+				feedbackCreateInfo.pPipelineCreationFeedback = &feedback;
+				feedbackCreateInfo.pipelineStageCreationFeedbackCount = stageCount;
+				feedbackCreateInfo.pPipelineStageCreationFeedbacks = stageFeedbacks.data();
+				pNext = &feedbackCreateInfo;
+				active = true;
+			}
+			~scope() { pNext = pNext_original; }
+			void Record(VkPipeline pipeline) {
+				if (!active || !(feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT))
+					return;
+				record newRecord = { std::move(nextName), pipeline, bindPoint, 0, usedCache, feedback };
+				nextName.clear();
+				for (size_t i = 0; i < stageFeedbacks.size(); i++)
+					newRecord.stages.emplace_back(pStages[i].stage, stageFeedbacks[i]);
+				Registry().Add(std::move(newRecord));
+			}
+		};
+	private:
+		std::mutex mutex;
+		std::vector<record> records;
+		std::map<uint64_t, uint64_t> frameDurations; //帧序号到该帧内编译耗时（纳秒）
+		std::atomic<uint64_t> currentFrame = 0;
+		inline static thread_local std::string nextName;
+
+		void Add(record&& newRecord) {
+			std::lock_guard lock(mutex);
+			newRecord.frame = currentFrame;
+			frameDurations[newRecord.frame] += newRecord.feedback.duration;
+			records.push_back(std::move(newRecord));
+		}
+	public:
+		//Static Function
+		static pipelineFeedback& Registry() {
+			static pipelineFeedback registry;
+			return registry;
+		}
+		//该函数须在创建逻辑设备前调用，Vulkan1.3以下的设备支持时启用扩展
+		static void RequestDeviceExtension() {
+			graphicsBase::Base().AddOptionalDeviceExtension(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+		}
+		static bool Available() {
+			return graphicsBase::Base().DeviceApiVersion() >= VK_API_VERSION_1_3 ||
+				graphicsBase::Base().IsDeviceExtensionEnabled(VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+		}
+		//为当前线程上下一个创建的管线命名，便于在报告中辨认
+		static void NameNext(std::string name) { nextName = std::move(name); }
+		//Non-const Function
+		//在每帧开始时调用，用以统计每帧的编译耗时
+		void NextFrame() { currentFrame++; }
+		//以拷贝返回，调用期间其他线程仍可创建管线
+		std::vector<record> Records() {
+			std::lock_guard lock(mutex);
+			return records;
+		}
+		void Clear() {
+			std::lock_guard lock(mutex);
+			records.clear();
+			frameDurations.clear();
+		}
+		//报告耗时最多的slowestCount个管线、管线缓存命中率、编译耗时最多的几帧
+		std::string Report(size_t slowestCount = 10) {
+			std::lock_guard lock(mutex);
+			uint64_t totalDuration = 0;
+			uint32_t cachedCount = 0, hitCount = 0;
+			for (auto& i : records)
+				totalDuration += i.feedback.duration,
+				cachedCount += i.usedCache,
+				hitCount += i.usedCache && i.CacheHit();
+			std::string report = std::format("[ pipelineFeedback ]\nPipelines created: {}, total {:.2f} ms\nPipeline cache hit ratio: {}/{}\n",
+				records.size(), totalDuration / 1e6, hitCount, cachedCount);
+			std::vector<const record*> slowest;
+			for (auto& i : records)
+				slowest.push_back(&i);
+			slowestCount = std::min(slowestCount, slowest.size());
+			std::ranges::partial_sort(slowest, slowest.begin() + slowestCount, std::ranges::greater{}, [](const record* p) { return p->feedback.duration; });
+			report += "Slowest pipelines:\n";
+			for (size_t i = 0; i < slowestCount; i++) {
+				auto& slow = *slowest[i];
+				report += std::format("  {:>8.2f} ms  {}  frame {}{}\n", slow.Milliseconds(),
+					slow.name.size() ? slow.name : std::format("0x{:016x}", uint64_t(slow.pipeline)),
+					slow.frame, slow.CacheHit() ? "  cache hit" : "");
+				for (auto& [stage, feedback] : slow.stages)
+					if (feedback.flags & VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT)
+						report += std::format("              stage 0x{:x}: {:.2f} ms\n", uint32_t(stage), feedback.duration / 1e6);
+			}
+			std::vector<std::pair<uint64_t, uint64_t>> frames(frameDurations.begin(), frameDurations.end());
+			size_t frameCount = std::min(slowestCount, frames.size());
+			std::ranges::partial_sort(frames, frames.begin() + frameCount, std::ranges::greater{}, &std::pair<uint64_t, uint64_t>::second);
+			report += "Compile time per frame (worst first):\n";
+			for (size_t i = 0; i < frameCount; i++)
+				report += std::format("  frame {}: {:.2f} ms\n", frames[i].first, frames[i].second / 1e6);
+			return report;
+		}
+	};
+
+	class pipelineCache {
+		VkPipelineCache handle = VK_NULL_HANDLE;
+	public:
+		pipelineCache() = default;
+		pipelineCache(VkPipelineCacheCreateInfo& createInfo) {
+			Create(createInfo);
+		}
+		pipelineCache(pipelineCache&& other) noexcept { MoveHandle; }
+		~pipelineCache() { DestroyHandleBy(vkDestroyPipelineCache); }
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Const Function
+		//取得缓存数据，用于存盘，下次启动时作为initialData创建
+		result_t GetData(std::vector<uint8_t>& data) const {
+			size_t dataSize = 0;
+			if (VkResult result = vkGetPipelineCacheData(graphicsBase::Base().Device(), handle, &dataSize, nullptr)) {
+				outStream << std::format("[ pipelineCache ] ERROR\nFailed to get the size of pipeline cache data!\nError code: {}\n", int32_t(result));
+				return result;
+			}
+			data.resize(dataSize);
+			VkResult result = vkGetPipelineCacheData(graphicsBase::Base().Device(), handle, &dataSize, data.data());
+			if (result)
+				outStream << std::format("[ pipelineCache ] ERROR\nFailed to get pipeline cache data!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		//Non-const Function
+		result_t Create(VkPipelineCacheCreateInfo& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+			VkResult result = vkCreatePipelineCache(graphicsBase::Base().Device(), &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ pipelineCache ] ERROR\nFailed to create a pipeline cache!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		//initialData来自其他设备或驱动版本时会被实现忽略，不会出错
+		result_t Create(std::span<const uint8_t> initialData = {}, VkPipelineCacheCreateFlags flags = 0) {
+			VkPipelineCacheCreateInfo createInfo = {
+				.flags = flags,
+				.initialDataSize = initialData.size(),
+				.pInitialData = initialData.data()
+			};
+			return Create(createInfo);
+		}
+	};
 
 	class pipeline {
 		VkPipeline handle = VK_NULL_HANDLE;
 	public:
 		pipeline() = default;
 		// 图形管线
-		pipeline(VkGraphicsPipelineCreateInfo& createInfo) {
-			Create(createInfo);
+		pipeline(VkGraphicsPipelineCreateInfo& createInfo, VkPipelineCache cache = VK_NULL_HANDLE) {
+			Create(createInfo, cache);
 		}
 		// 计算管线
-		pipeline(VkComputePipelineCreateInfo& createInfo) {
-			Create(createInfo);
+		pipeline(VkComputePipelineCreateInfo& createInfo, VkPipelineCache cache = VK_NULL_HANDLE) {
+			Create(createInfo, cache);
 		}
 		pipeline(pipeline&& other) noexcept { MoveHandle; }
 		~pipeline() { DestroyHandleBy(vkDestroyPipeline); }
+		DefineMoveAssignmentOperator(pipeline);
 		//Getter
 		DefineHandleTypeOperator;
 		DefineAddressFunction;
 		//Non-const Function
-		result_t Create(VkGraphicsPipelineCreateInfo& createInfo) {
+		result_t Create(VkGraphicsPipelineCreateInfo& createInfo, VkPipelineCache cache = VK_NULL_HANDLE) {
 			createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-			VkResult result = vkCreateGraphicsPipelines(graphicsBase::Base().Device(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &handle);
+			pipelineFeedback::scope feedback(createInfo.pNext, createInfo.stageCount, createInfo.pStages, VK_PIPELINE_BIND_POINT_GRAPHICS, cache);
+			VkResult result = vkCreateGraphicsPipelines(graphicsBase::Base().Device(), cache, 1, &createInfo, nullptr, &handle);
 			if (result)
 				outStream << std::format("[ pipeline ] ERROR\nFailed to create a graphics pipeline!\nError code: {}\n", int32_t(result));
+			else
+				feedback.Record(handle);
 			return result;
 		}
-		result_t Create(VkComputePipelineCreateInfo& createInfo) {
+		result_t Create(VkComputePipelineCreateInfo& createInfo, VkPipelineCache cache = VK_NULL_HANDLE) {
 			createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-			VkResult result = vkCreateComputePipelines(graphicsBase::Base().Device(), VK_NULL_HANDLE, 1, &createInfo, nullptr, &handle);
+			pipelineFeedback::scope feedback(createInfo.pNext, 1, &createInfo.stage, VK_PIPELINE_BIND_POINT_COMPUTE, cache);
+			VkResult result = vkCreateComputePipelines(graphicsBase::Base().Device(), cache, 1, &createInfo, nullptr, &handle);
 			if (result)
 				outStream << std::format("[ pipeline ] ERROR\nFailed to create a compute pipeline!\nError code: {}\n", int32_t(result));
+			else
+				feedback.Record(handle);
 			return result;
 		}
+		//该函数用于将图形管线库链接为完整的管线（VK_EXT_graphics_pipeline_library）
+		//linkTimeOptimization为false时为快速链接，为true时做链接期优化，后者要求管线库在创建时保留了链接期优化信息
+		result_t Link(arrayRef<const VkPipeline> libraries, VkPipelineLayout layout, bool linkTimeOptimization = false, VkPipelineCreateFlags flags = 0) {
+			VkPipelineLibraryCreateInfoKHR libraryCreateInfo = {
+				.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+				.libraryCount = uint32_t(libraries.Count()),
+				.pLibraries = libraries.Pointer()
+			};
+			VkGraphicsPipelineCreateInfo createInfo = {
+				.pNext = &libraryCreateInfo,
+				.flags = flags | (linkTimeOptimization ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0),
+				.layout = layout,
+				.basePipelineIndex = -1
+			};
+			return Create(createInfo);
+		}
+	};
+
+	//VK_EXT_shader_object：不经管线，直接按阶段绑定着色器，所有状态均为动态状态
+	class shaderObject {
+		VkShaderEXT handle = VK_NULL_HANDLE;
+	public:
+		struct functions_t {
+			PFN_vkCreateShadersEXT vkCreateShadersEXT = DeviceProcAddr(vkCreateShadersEXT);
+			PFN_vkDestroyShaderEXT vkDestroyShaderEXT = DeviceProcAddr(vkDestroyShaderEXT);
+			PFN_vkCmdBindShadersEXT vkCmdBindShadersEXT = DeviceProcAddr(vkCmdBindShadersEXT);
+			PFN_vkCmdSetVertexInputEXT vkCmdSetVertexInputEXT = DeviceProcAddr(vkCmdSetVertexInputEXT);
+			PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = DeviceProcAddr(vkCmdSetPolygonModeEXT);
+			PFN_vkCmdSetRasterizationSamplesEXT vkCmdSetRasterizationSamplesEXT = DeviceProcAddr(vkCmdSetRasterizationSamplesEXT);
+			PFN_vkCmdSetSampleMaskEXT vkCmdSetSampleMaskEXT = DeviceProcAddr(vkCmdSetSampleMaskEXT);
+			PFN_vkCmdSetAlphaToCoverageEnableEXT vkCmdSetAlphaToCoverageEnableEXT = DeviceProcAddr(vkCmdSetAlphaToCoverageEnableEXT);
+			PFN_vkCmdSetAlphaToOneEnableEXT vkCmdSetAlphaToOneEnableEXT = DeviceProcAddr(vkCmdSetAlphaToOneEnableEXT);
+			PFN_vkCmdSetDepthClampEnableEXT vkCmdSetDepthClampEnableEXT = DeviceProcAddr(vkCmdSetDepthClampEnableEXT);
+			PFN_vkCmdSetLogicOpEnableEXT vkCmdSetLogicOpEnableEXT = DeviceProcAddr(vkCmdSetLogicOpEnableEXT);
+			PFN_vkCmdSetLogicOpEXT vkCmdSetLogicOpEXT = DeviceProcAddr(vkCmdSetLogicOpEXT);
+			PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT = DeviceProcAddr(vkCmdSetColorBlendEnableEXT);
+			PFN_vkCmdSetColorBlendEquationEXT vkCmdSetColorBlendEquationEXT = DeviceProcAddr(vkCmdSetColorBlendEquationEXT);
+			PFN_vkCmdSetColorWriteMaskEXT vkCmdSetColorWriteMaskEXT = DeviceProcAddr(vkCmdSetColorWriteMaskEXT);
+		};
+		static const functions_t& Functions() {
+			static const functions_t functions;
+			return functions;
+		}
+		shaderObject() = default;
+		shaderObject(VkShaderCreateInfoEXT& createInfo) {
+			Create(createInfo);
+		}
+		shaderObject(const char* filepath, VkShaderStageFlagBits stage, VkShaderStageFlags nextStage = 0,
+			arrayRef<const VkDescriptorSetLayout> setLayouts = {}, arrayRef<const VkPushConstantRange> pushConstantRanges = {},
+			const char* entry = "main", const VkSpecializationInfo* pSpecializationInfo = nullptr) {
+			Create(filepath, stage, nextStage, setLayouts, pushConstantRanges, entry, pSpecializationInfo);
+		}
+		shaderObject(shaderObject&& other) noexcept { MoveHandle; }
+		~shaderObject() {
+			if (handle) {
+				Functions().vkDestroyShaderEXT(graphicsBase::Base().Device(), handle, nullptr);
+				handle = VK_NULL_HANDLE;
+			}
+		}
+		DefineMoveAssignmentOperator(shaderObject);
+		//Getter
+		DefineHandleTypeOperator;
+		DefineAddressFunction;
+		//Static Function
+		//按阶段绑定着色器，shaders中的VK_NULL_HANDLE表示解绑相应阶段
+		static void CmdBind(VkCommandBuffer commandBuffer, arrayRef<const VkShaderStageFlagBits> stages, arrayRef<const VkShaderEXT> shaders) {
+			Functions().vkCmdBindShadersEXT(commandBuffer, uint32_t(stages.Count()), stages.Pointer(), shaders.Pointer());
+		}
+		//绑定顶点和片段着色器，并解绑设备支持的其他图形阶段（不用管线时，所有已启用的图形阶段都必须有绑定）
+		static void CmdBindGraphics(VkCommandBuffer commandBuffer, VkShaderEXT vertexShader, VkShaderEXT fragmentShader) {
+			VkShaderStageFlagBits stages[5] = { VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT };
+			VkShaderEXT shaders[5] = { vertexShader, fragmentShader };
+			uint32_t count = 2;
+			if (graphicsBase::Base().PhysicalDeviceFeatures().tessellationShader)
+				stages[count++] = VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT,
+				stages[count++] = VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+			if (graphicsBase::Base().PhysicalDeviceFeatures().geometryShader)
+				stages[count++] = VK_SHADER_STAGE_GEOMETRY_BIT;
+			CmdBind(commandBuffer, { stages, count }, { shaders, count });
+		}
+		//同时创建多个着色器对象，以VK_SHADER_CREATE_LINK_STAGE_BIT_EXT链接，便于实现做跨阶段优化
+		static result_t CreateLinked(arrayRef<shaderObject> shaders, arrayRef<VkShaderCreateInfoEXT> createInfos) {
+			std::vector<VkShaderEXT> handles(createInfos.Count());
+			for (auto& i : createInfos)
+				i.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT,
+				i.flags |= VK_SHADER_CREATE_LINK_STAGE_BIT_EXT;
+			VkResult result = Functions().vkCreateShadersEXT(graphicsBase::Base().Device(), uint32_t(createInfos.Count()), createInfos.Pointer(), nullptr, handles.data());
+			if (result) {
+				outStream << std::format("[ shaderObject ] ERROR\nFailed to create linked shader objects!\nError code: {}\n", int32_t(result));
+				return result;
+			}
+			for (size_t i = 0; i < shaders.Count(); i++)
+				shaders[i] = shaderObject(),
+				shaders[i].handle = handles[i];
+			return VK_SUCCESS;
+		}
+		//Non-const Function
+		result_t Create(VkShaderCreateInfoEXT& createInfo) {
+			createInfo.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+			VkResult result = Functions().vkCreateShadersEXT(graphicsBase::Base().Device(), 1, &createInfo, nullptr, &handle);
+			if (result)
+				outStream << std::format("[ shaderObject ] ERROR\nFailed to create a shader object!\nError code: {}\n", int32_t(result));
+			return result;
+		}
+		//与shaderModule一样由SPIR-V文件创建，nextStage为后续可能绑定的阶段
+		result_t Create(const char* filepath, VkShaderStageFlagBits stage, VkShaderStageFlags nextStage = 0,
+			arrayRef<const VkDescriptorSetLayout> setLayouts = {}, arrayRef<const VkPushConstantRange> pushConstantRanges = {},
+			const char* entry = "main", const VkSpecializationInfo* pSpecializationInfo = nullptr) {
+			std::vector<uint32_t> code;
+			if (VkResult result = shaderModule::ReadCode(filepath, code))
+				return result;
+			VkShaderCreateInfoEXT createInfo = {
+				.stage = stage,
+				.nextStage = nextStage,
+				.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT,
+				.codeSize = code.size() * 4,
+				.pCode = code.data(),
+				.pName = entry,
+				.setLayoutCount = uint32_t(setLayouts.Count()),
+				.pSetLayouts = setLayouts.Pointer(),
+				.pushConstantRangeCount = uint32_t(pushConstantRanges.Count()),
+				.pPushConstantRanges = pushConstantRanges.Pointer(),
+				.pSpecializationInfo = pSpecializationInfo
+			};
+			return Create(createInfo);
+		}
 	};
-}
+}
\ No newline at end of file
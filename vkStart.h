@@ -16,6 +16,17 @@
 #include <chrono>
 #include <numeric>
 #include <numbers>
+#include <algorithm>
+#include <array>
+#include <set>
+#include <bitset>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <condition_variable>
 
 // GLM
 // NDC_depth: [-1, 1] => [0, 1]